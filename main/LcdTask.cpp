@@ -212,8 +212,8 @@ void LcdTask::DoTask() {
 						sprintf(szValue, "% 6d", rpm);
 						_plcd->setFont(&FONT24);
 						_plcd->setTextColor(TFT_WHITE, TFT_BLACK);
-						_plcd->setCursor(cx - 40, height - 60);
-						_plcd->print(szValue);
+						_plcd->setTextTabular(true);		// fixed width digits, drawn in one push
+						_plcd->drawString(szValue, cx - 40, height - 60);
 						tick1s = 0;
 						prevrpm = rpm;
 					}
@@ -232,8 +232,8 @@ void LcdTask::DoTask() {
 				sprintf(szValue, "% 6d", rpm);
 				_plcd->setFont(&FONT24);
 				_plcd->setTextColor(TFT_WHITE, TFT_BLACK);
-				_plcd->setCursor(cx - 40, height - 60);
-				_plcd->print(szValue);
+				_plcd->setTextTabular(true);		// fixed width digits, drawn in one push
+				_plcd->drawString(szValue, cx - 40, height - 60);
 			}
 			prevrpm = rpm;
 		}
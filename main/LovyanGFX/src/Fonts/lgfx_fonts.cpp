@@ -15,6 +15,17 @@
 
 namespace lgfx
 {
+  bool IFont::isInsideClip(const LGFXBase* gfx, std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h)
+  {
+    return x >= gfx->_clip_l && x + w - 1 <= gfx->_clip_r
+        && y >= gfx->_clip_t && y + h - 1 <= gfx->_clip_b;
+  }
+
+  void IFont::writeRawColor(LGFXBase* gfx, std::uint32_t color, std::int32_t length)
+  {
+    gfx->writeRawColor(color, length);
+  }
+
   void BaseFont::getDefaultMetric(FontMetrics *metrics) const
   {
     metrics->width    = width;
@@ -262,63 +273,95 @@ namespace lgfx
     std::uint32_t colortbl[2] = {gfx->getColorConverter()->convert(style->back_rgb888), gfx->getColorConverter()->convert(style->fore_rgb888)};
     bool fillbg = (style->back_rgb888 != style->fore_rgb888);
 
-    //std::int32_t clip_left   = gfx->_clip_l;
-    //std::int32_t clip_right  = gfx->_clip_r;
-    //std::int32_t clip_top    = gfx->_clip_t;
-    //std::int32_t clip_bottom = gfx->_clip_b;
-
     float sx = style->size_x;
     float sy = style->size_y;
 
-    //if ((x <= clip_right) && (clip_left < (x + fontWidth  * sx ))
-    // && (y <= clip_bottom) && (clip_top < (y + fontHeight * sy )))
-    {
-//      if (!fillbg || sy != 1.0 || x < clip_left || y < clip_top || y + fontHeight > clip_bottom || x + fontWidth * sx > clip_right) {
-        bool flg = false;
-        std::uint8_t line = 0, i = 0, j = 0;
-        std::int32_t len;
-        std::int32_t y0 = 0;
-        std::int32_t y1 = sy;
-        std::int32_t x0 = 0;
-        gfx->startWrite();
+    std::int32_t isx = sx;
+    std::int32_t isy = sy;
+    if (fillbg && isx == sx && isy == sy && 0 < isx && 0 < isy
+     && isInsideClip(gfx, x, y, fontWidth * isx, fontHeight * isy))
+    { // 背景を塗る場合はグリフ全体を1つのウィンドウとし、ランを横方向のスパンとして連続送信する
+      // 同色のスパンは行をまたいでまとめ、sy 倍の場合は1行分のスパンを繰り返す
+      // 幅は widthtbl (uint8_t) 由来なので 1行のスパン数は 256 を超えない
+      std::uint8_t span_flg[256];
+      std::uint8_t span_len[256];
+      std::int32_t line = 0;
+      bool flg = false;
+      bool pending_flg = false;
+      std::int32_t pending = 0;
+
+      gfx->startWrite();
+      gfx->setWindow(x, y, x + fontWidth * isx - 1, y + fontHeight * isy - 1);
+      std::int32_t i = 0;
+      do {
+        std::int32_t spans = 0;
+        std::int32_t j = 0;
+        do {
+          if (!line) {
+            line = *font_addr++;
+            flg = line & 0x80;
+            line = (line & 0x7F) + 1;
+          }
+          std::int32_t len = std::min<std::int32_t>(line, fontWidth - j);
+          line -= len;
+          j += len;
+          if (spans && span_flg[spans - 1] == flg) {
+            span_len[spans - 1] += len;
+          } else {
+            span_flg[spans] = flg;
+            span_len[spans] = len;
+            ++spans;
+          }
+        } while (j < fontWidth);
+
+        std::int32_t r = isy;
         do {
-          line = *font_addr++;
-          flg = line & 0x80;
-          line = (line & 0x7F)+1;
+          std::int32_t k = 0;
           do {
-            len = (line > fontWidth - j) ? fontWidth - j : line;
-            line -= len;
-            j += len;
-            std::int32_t x1 = j * sx;
-            if (fillbg || flg) {
-              gfx->setRawColor(colortbl[flg]);
-              gfx->writeFillRect( x + x0, y + y0, x1 - x0, y1 - y0);
+            if (pending_flg != (bool)span_flg[k]) {
+              writeRawColor(gfx, colortbl[pending_flg], pending);
+              pending_flg = span_flg[k];
+              pending = 0;
             }
-            x0 = x1;
-            if (j == fontWidth) {
-              j = 0;
-              x0 = 0;
-              y0 = y1;
-              y1 = (++i + 1) * sy;
-            }
-          } while (line);
-        } while (i < fontHeight);
-        gfx->endWrite();
-/*
-      } else {
-        std::uint32_t line = 0;
-        gfx->startWrite();
-        gfx->setAddrWindow(x, y, fontWidth * style->size_x, fontHeight);
-        std::uint32_t len = fontWidth * style->size_x * fontHeight;
+            pending += span_len[k] * isx;
+          } while (++k < spans);
+        } while (--r);
+      } while (++i < fontHeight);
+      writeRawColor(gfx, colortbl[pending_flg], pending);
+      gfx->endWrite();
+    }
+    else
+    {
+      bool flg = false;
+      std::uint8_t line = 0, i = 0, j = 0;
+      std::int32_t len;
+      std::int32_t y0 = 0;
+      std::int32_t y1 = sy;
+      std::int32_t x0 = 0;
+      gfx->startWrite();
+      do {
+        line = *font_addr++;
+        flg = line & 0x80;
+        line = (line & 0x7F)+1;
         do {
-          line = *font_addr++;
-          bool flg = line & 0x80;
-          line = ((line & 0x7F) + 1) * style->size_x;
-          gfx->writeRawColor(colortbl[flg], line);
-        } while (len -= line);
-        gfx->endWrite();
-      }
-//*/
+          len = (line > fontWidth - j) ? fontWidth - j : line;
+          line -= len;
+          j += len;
+          std::int32_t x1 = j * sx;
+          if (fillbg || flg) {
+            gfx->setRawColor(colortbl[flg]);
+            gfx->writeFillRect( x + x0, y + y0, x1 - x0, y1 - y0);
+          }
+          x0 = x1;
+          if (j == fontWidth) {
+            j = 0;
+            x0 = 0;
+            y0 = y1;
+            y1 = (++i + 1) * sy;
+          }
+        } while (line);
+      } while (i < fontHeight);
+      gfx->endWrite();
     }
 
     return fontWidth * sx;
@@ -336,6 +379,22 @@ namespace lgfx
     return true;
   }
 
+  bool GFXfont::rangeSorted(void) const {
+    std::uint32_t memo = _memo.load(std::memory_order_acquire);
+    if (!(memo & memo_checked)) {
+      memo = memo_checked | memo_sorted;
+      for (size_t i = 0; i < range_num; ++i) {
+        if (range[i].start > range[i].end
+         || (i && range[i - 1].end >= range[i].start)) {
+          memo = memo_checked;
+          break;
+        }
+      }
+      _memo.fetch_or(memo, std::memory_order_release);
+    }
+    return memo & memo_sorted;
+  }
+
   GFXglyph* GFXfont::getGlyph(std::uint16_t uniCode) const {
     if (uniCode > last 
     ||  uniCode < first) return nullptr;
@@ -346,39 +405,56 @@ namespace lgfx
     }
     auto range_pst = range;
     size_t i = 0;
-    while ((uniCode > range_pst[i].end) 
-        || (uniCode < range_pst[i].start)) {
-      if (++i == custom_range_num) return nullptr;
+    if (rangeSorted()) {
+      size_t hi = custom_range_num;
+      while (i < hi) {
+        size_t mid = (i + hi) >> 1;
+        if (range_pst[mid].end < uniCode) i = mid + 1;
+        else                              hi = mid;
+      }
+      if (i == custom_range_num || uniCode < range_pst[i].start) return nullptr;
+    } else {
+      while ((uniCode > range_pst[i].end) 
+          || (uniCode < range_pst[i].start)) {
+        if (++i == custom_range_num) return nullptr;
+      }
     }
     uniCode -= range_pst[i].start - range_pst[i].base;
     return &glyph[uniCode];
   }
 
   void GFXfont::getDefaultMetric(lgfx::FontMetrics *metrics) const {
-    std::int_fast8_t glyph_ab = 0;   // glyph delta Y (height) above baseline
-    std::int_fast8_t glyph_bb = 0;   // glyph delta Y (height) below baseline
-    size_t numChars = last - first;
-
-    size_t custom_range_num = range_num;
-    if (custom_range_num != 0) {
-      EncodeRange *range_pst = range;
-      size_t i = 0;
-      numChars = custom_range_num;
-      do {
-        numChars += range_pst[i].end - range_pst[i].start;
-      } while (++i < custom_range_num);
-    }
+    std::uint32_t memo = _memo.load(std::memory_order_acquire);
+    if (!(memo & memo_metric)) {
+      std::int_fast8_t glyph_ab = 0;   // glyph delta Y (height) above baseline
+      std::int_fast8_t glyph_bb = 0;   // glyph delta Y (height) below baseline
+      size_t numChars = last - first;
+
+      size_t custom_range_num = range_num;
+      if (custom_range_num != 0) {
+        EncodeRange *range_pst = range;
+        size_t i = 0;
+        numChars = custom_range_num;
+        do {
+          numChars += range_pst[i].end - range_pst[i].start;
+        } while (++i < custom_range_num);
+      }
 
-    // Find the biggest above and below baseline offsets
-    for (size_t c = 0; c < numChars; c++)
-    {
-      GFXglyph *glyph1 = &glyph[c];
-      std::int_fast8_t ab = -glyph1->yOffset;
-      if (ab > glyph_ab) glyph_ab = ab;
-      std::int_fast8_t bb = glyph1->height - ab;
-      if (bb > glyph_bb) glyph_bb = bb;
+      // Find the biggest above and below baseline offsets
+      for (size_t c = 0; c < numChars; c++)
+      {
+        GFXglyph *glyph1 = &glyph[c];
+        std::int_fast8_t ab = -glyph1->yOffset;
+        if (ab > glyph_ab) glyph_ab = ab;
+        std::int_fast8_t bb = glyph1->height - ab;
+        if (bb > glyph_bb) glyph_bb = bb;
+      }
+      memo = memo_metric | (std::uint8_t)glyph_ab << 8 | (std::uint8_t)glyph_bb << 16;
+      _memo.fetch_or(memo, std::memory_order_release);
     }
 
+    std::int_fast8_t glyph_ab = (std::int8_t)(memo >> 8);
+    std::int_fast8_t glyph_bb = (std::int8_t)(memo >> 16);
     metrics->baseline = glyph_ab;
     metrics->y_offset = - glyph_ab;
     metrics->height   = glyph_bb + glyph_ab;
@@ -515,10 +591,116 @@ namespace lgfx
   };
 
 
+  // グリフ検索用インデックス。
+  // ascii  : 0x00-0xFF のグリフ位置 (font+23 からのオフセット+1, 0は未収録)
+  // code/pos : Unicodeグリフを INDEX_STEP 個おきに抜き出した昇順テーブル
+  struct U8g2font::glyph_index_t
+  {
+    static constexpr std::uint32_t INDEX_SHIFT = 4;
+    static constexpr std::uint32_t INDEX_STEP = 1 << INDEX_SHIFT;
+
+    std::uint16_t ascii[256];
+    std::uint32_t count;
+    const std::uint8_t* unicode_top;
+    std::uint32_t* pos;
+    std::uint16_t* code;
+  };
+
+  static const uint8_t* u8g2_unicode_top(const uint8_t* font, std::uint16_t start_pos_unicode)
+  {
+    if (!start_pos_unicode) return nullptr;
+    font += start_pos_unicode;
+    return font + (font[0] << 8 | font[1]);
+  }
+
+  // フォントは複数タスクから共有されるため、作成したインデックスは
+  // compare_exchange で一度だけ公開し、競合して負けた側は自分の分を破棄する。
+  bool U8g2font::buildGlyphIndex(void) const
+  {
+    if (_index.load(std::memory_order_acquire)) return true;
+    if (_index_failed.load(std::memory_order_relaxed)) return false;
+
+    const uint8_t *top = &this->_font[23];
+    const uint8_t *unicode_top = u8g2_unicode_top(top, start_pos_unicode());
+
+    std::uint32_t glyphs = 0;
+    if (unicode_top)
+    {
+      for (auto font = unicode_top; 0 != (font[0] << 8 | font[1]); font += font[2]) ++glyphs;
+    }
+    std::uint32_t count = (glyphs + glyph_index_t::INDEX_STEP - 1) >> glyph_index_t::INDEX_SHIFT;
+
+    auto index = (glyph_index_t*)heap_alloc(sizeof(glyph_index_t) + count * (sizeof(std::uint32_t) + sizeof(std::uint16_t)));
+    if (!index) { _index_failed.store(true, std::memory_order_relaxed); return false; }
+
+    memset(index->ascii, 0, sizeof(index->ascii));
+    for (auto font = top; font[1]; font += font[1])
+    {
+      if (!index->ascii[font[0]]) index->ascii[font[0]] = font - top + 1;
+    }
+
+    index->count = count;
+    index->unicode_top = unicode_top;
+    index->pos  = (std::uint32_t*)&index[1];
+    index->code = (std::uint16_t*)&index->pos[count];
+    std::uint32_t i = 0;
+    for (auto font = unicode_top; i < glyphs; font += font[2])
+    {
+      if (!(i & (glyph_index_t::INDEX_STEP - 1)))
+      {
+        auto idx = i >> glyph_index_t::INDEX_SHIFT;
+        index->pos[idx]  = font - unicode_top;
+        index->code[idx] = font[0] << 8 | font[1];
+      }
+      ++i;
+    }
+    glyph_index_t* expected = nullptr;
+    if (!_index.compare_exchange_strong(expected, index, std::memory_order_acq_rel, std::memory_order_acquire))
+    {
+      heap_free(index);
+    }
+    return true;
+  }
+
+  void U8g2font::releaseGlyphIndex(void) const
+  {
+    auto index = _index.exchange(nullptr, std::memory_order_acq_rel);
+    _index_failed.store(false, std::memory_order_relaxed);
+    if (index) heap_free(index);
+  }
+
   const uint8_t* U8g2font::getGlyph(std::uint16_t encoding) const
   {
     const uint8_t *font = &this->_font[23];
 
+    auto index = _index.load(std::memory_order_acquire);
+    if (index || (buildGlyphIndex() && (index = _index.load(std::memory_order_acquire))))
+    {
+      if ( encoding <= 255 )
+      {
+        std::uint_fast16_t pos = index->ascii[encoding];
+        return pos ? font + pos + 1 : nullptr;  /* skip encoding and glyph size */
+      }
+
+      // 抜き出しテーブルを二分探索し、該当ブロック内を最大 INDEX_STEP 個だけ辿る
+      std::uint32_t lo = 0;
+      std::uint32_t hi = index->count;
+      while (lo < hi)
+      {
+        std::uint32_t mid = (lo + hi) >> 1;
+        if (index->code[mid] <= encoding) lo = mid + 1;
+        else                              hi = mid;
+      }
+      if (lo == 0) return nullptr;
+      font = index->unicode_top + index->pos[lo - 1];
+      for (std::uint_fast16_t e; 0 != (e = font[0] << 8 | font[1]); font += font[2])
+      {
+        if ( e == encoding ) { return font + 3; }  /* skip encoding and glyph size */
+        if ( e > encoding ) break;
+      }
+      return nullptr;
+    }
+
     if ( encoding <= 255 )
     {
       if ( encoding >= 'a' )      { font += this->start_pos_lower_a(); }
@@ -684,6 +866,148 @@ namespace lgfx
     return xAdvance;
   }
 
+//----------------------------------------------------------------------------
+
+  const AAglyph* AAfont::getGlyph(std::uint16_t uniCode) const
+  {
+    std::size_t lo = 0;
+    std::size_t hi = glyph_num;
+    while (lo < hi)
+    {
+      std::size_t mid = (lo + hi) >> 1;
+      if (glyph[mid].unicode < uniCode) lo = mid + 1;
+      else                              hi = mid;
+    }
+    return (lo < glyph_num && glyph[lo].unicode == uniCode) ? &glyph[lo] : nullptr;
+  }
+
+  void AAfont::getDefaultMetric(FontMetrics *metrics) const
+  {
+    metrics->baseline  = ascent;
+    metrics->y_offset  = - ascent;
+    metrics->height    = ascent + descent;
+    metrics->y_advance = yAdvance;
+    metrics->x_offset  = 0;
+  }
+
+  bool AAfont::updateFontMetric(FontMetrics *metrics, std::uint16_t uniCode) const
+  {
+    auto glyph = getGlyph(uniCode);
+    if (!glyph) return false;
+    metrics->x_offset  = glyph->xOffset;
+    metrics->width     = glyph->width;
+    metrics->x_advance = glyph->xAdvance;
+    return true;
+  }
+
+  std::size_t AAfont::drawChar(LGFXBase* gfx, std::int32_t x, std::int32_t y, std::uint16_t uniCode, const TextStyle* style) const
+  {
+    auto glyph = getGlyph(uniCode);
+    if (!glyph) return 0;
+
+    std::int32_t w = glyph->width;
+    std::int32_t h = glyph->height;
+
+    float sx = style->size_x;
+    float sy = style->size_y;
+
+    std::int32_t xAdvance = sx * glyph->xAdvance;
+    std::int32_t xoffset  = sx * glyph->xOffset;
+
+    bool fillbg = (style->back_rgb888 != style->fore_rgb888);
+
+    // 階調ごとに前景色と背景色をブレンドした色 (色が変わらない間は作り直さない)
+    std::uint_fast8_t shift = bpp;
+    std::uint32_t mask = (1 << shift) - 1;
+    auto colortbl = gfx->_get_blend_table(style->fore_rgb888, fillbg ? style->back_rgb888 : gfx->getBaseColor(), shift);
+
+    std::int32_t left  = 0;
+    std::int32_t right = 0;
+    if (fillbg) {
+      left  = std::max<int>(gfx->_get_text_filled_x(), x + (xoffset < 0 ? xoffset : 0));
+      right = x + std::max<int>(w * sx + xoffset, xAdvance);
+    }
+    gfx->_set_text_filled_x(right);
+
+    auto font_metrics = gfx->_get_font_metrics();
+    x += xoffset;
+    y += int(font_metrics.y_offset * sy);
+    std::int32_t yoffset = (- font_metrics.y_offset) + glyph->yOffset;
+
+    gfx->startWrite();
+
+    if (left < right)
+    {
+      gfx->setRawColor(colortbl[0]);
+      if (yoffset > 0) {
+        gfx->writeFillRect(left, y, right - left, yoffset * sy);
+      }
+      std::int32_t y0 = (yoffset + h) * sy;
+      std::int32_t y1 = font_metrics.height * sy;
+      if (y0 < y1) {
+        gfx->writeFillRect(left, y + y0, right - left, y1 - y0);
+      }
+      if (w > 0)
+      {
+        y0 = int(yoffset * sy);
+        std::int32_t len = int((yoffset + h) * sy) - y0;
+        if (left < x)
+        {
+          gfx->writeFillRect(left, y + y0, x - left, len);
+        }
+        std::int32_t xwsx = x + int(w * sx);
+        if (xwsx < right)
+        {
+          gfx->writeFillRect(xwsx, y + y0, right - xwsx, len);
+        }
+      }
+    }
+
+    if (w > 0 && h > 0)
+    {
+      left -= x;
+      auto rle = &bitmap[glyph->bitmapOffset];
+      std::int32_t lx = 0;
+      std::int32_t ly = 0;
+      std::int32_t y0 = (yoffset    ) * sy;
+      std::int32_t y1 = (yoffset + 1) * sy;
+      do
+      {
+        std::uint32_t level = *rle & mask;
+        std::int32_t run = (*rle++ >> shift) + 1;
+        do
+        {
+          std::int32_t len = std::min(run, w - lx);
+          run -= len;
+          if (level || fillbg)
+          {
+            std::int32_t x0 = lx * sx;
+            if (!level && x0 < left) x0 = left;
+            std::int32_t x1 = (lx + len) * sx;
+            if (x0 < x1)
+            {
+              gfx->setRawColor(colortbl[level]);
+              gfx->writeFillRect( x + x0
+                                , y + y0
+                                , x1 - x0
+                                , y1 - y0);
+            }
+          }
+          lx += len;
+          if (lx == w)
+          {
+            lx = 0;
+            ++ly;
+            y0 = y1;
+            y1 = (ly + yoffset + 1) * sy;
+          }
+        } while (run && ly < h);
+      } while (ly < h);
+    }
+    gfx->endWrite();
+    return xAdvance;
+  }
+
 //----------------------------------------------------------------------------
 
   void VLWfont::getDefaultMetric(FontMetrics *metrics) const {
@@ -700,6 +1024,8 @@ namespace lgfx
 
   bool VLWfont::unloadFont(void) {
     _fontLoaded = false;
+    setGlyphCacheSize(0);
+    if (_scratch)  { heap_free(_scratch);  _scratch  = nullptr; _scratch_size = 0; }
     if (gUnicode)  { heap_free(gUnicode);  gUnicode  = nullptr; }
     if (gWidth)    { heap_free(gWidth);    gWidth    = nullptr; }
     if (gxAdvance) { heap_free(gxAdvance); gxAdvance = nullptr; }
@@ -710,10 +1036,162 @@ namespace lgfx
       _fontData->close();
       _fontData->postRead();
       _fontData = nullptr;
+      _fontMem = nullptr;
     }
     return true;
   }
 
+  // グリフのヘッダとビットマップを保持するLRUキャッシュ
+  // 検索はグリフ番号のハッシュで行い、双方向リストは使用順の管理にのみ使う
+  struct VLWfont::glyph_cache_t
+  {
+    static constexpr std::uint32_t HASH_SIZE = 64;
+
+    struct entry_t
+    {
+      entry_t* prev;
+      entry_t* next;
+      entry_t* hnext;  // 同じハッシュ値の次のエントリ
+      std::uint32_t header[6];
+      std::uint32_t length;
+      std::uint16_t gNum;
+      std::uint8_t* bitmap(void) { return reinterpret_cast<std::uint8_t*>(&this[1]); }
+    };
+
+    entry_t* head = nullptr;  // most recently used
+    entry_t* tail = nullptr;
+    entry_t* hash[HASH_SIZE] = {};
+    std::uint32_t budget = 0;
+    std::uint32_t used = 0;
+    std::uint32_t hits = 0;
+    std::uint32_t misses = 0;
+    bool psram = false;
+
+    void unlink(entry_t* e)
+    {
+      if (e->prev) e->prev->next = e->next; else head = e->next;
+      if (e->next) e->next->prev = e->prev; else tail = e->prev;
+    }
+
+    void push_front(entry_t* e)
+    {
+      e->prev = nullptr;
+      e->next = head;
+      if (head) head->prev = e; else tail = e;
+      head = e;
+    }
+
+    entry_t* find(std::uint16_t gNum) const
+    {
+      auto e = hash[gNum & (HASH_SIZE - 1)];
+      while (e && e->gNum != gNum) e = e->hnext;
+      return e;
+    }
+
+    void insert(entry_t* e)
+    {
+      auto& bucket = hash[e->gNum & (HASH_SIZE - 1)];
+      e->hnext = bucket;
+      bucket = e;
+      push_front(e);
+    }
+
+    void evict(std::uint32_t limit)
+    {
+      while (tail && used > limit)
+      {
+        auto e = tail;
+        unlink(e);
+        auto p = &hash[e->gNum & (HASH_SIZE - 1)];
+        while (*p != e) p = &(*p)->hnext;
+        *p = e->hnext;
+        used -= sizeof(entry_t) + e->length;
+        heap_free(e);
+      }
+    }
+  };
+
+  void VLWfont::setGlyphCacheSize(std::uint32_t bytes, bool psram)
+  {
+    if (!bytes)
+    {
+      if (_glyph_cache)
+      {
+        _glyph_cache->evict(0);
+        delete _glyph_cache;
+        _glyph_cache = nullptr;
+      }
+      return;
+    }
+    if (!_glyph_cache) _glyph_cache = new glyph_cache_t();
+    _glyph_cache->budget = bytes;
+    _glyph_cache->psram = psram;
+    _glyph_cache->evict(bytes);
+  }
+
+  void VLWfont::clearGlyphCache(void)
+  {
+    if (!_glyph_cache) return;
+    _glyph_cache->evict(0);
+    _glyph_cache->hits = 0;
+    _glyph_cache->misses = 0;
+  }
+
+  std::uint32_t VLWfont::getGlyphCacheHits(void) const { return _glyph_cache ? _glyph_cache->hits : 0; }
+  std::uint32_t VLWfont::getGlyphCacheMisses(void) const { return _glyph_cache ? _glyph_cache->misses : 0; }
+
+  const std::uint8_t* VLWfont::cache_find(std::uint16_t gNum, std::uint32_t* header) const
+  {
+    auto cache = _glyph_cache;
+    if (!cache) return nullptr;
+    auto e = cache->find(gNum);
+    if (!e)
+    {
+      ++cache->misses;
+      return nullptr;
+    }
+    if (e != cache->head)
+    {
+      cache->unlink(e);
+      cache->push_front(e);
+    }
+    ++cache->hits;
+    memcpy(header, e->header, sizeof(e->header));
+    return e->bitmap();
+  }
+
+  std::uint8_t* VLWfont::cache_store(std::uint16_t gNum, const std::uint32_t* header, std::uint32_t length) const
+  {
+    auto cache = _glyph_cache;
+    if (!cache) return nullptr;
+    std::uint32_t size = sizeof(glyph_cache_t::entry_t) + length;
+    if (size > cache->budget) return nullptr;
+    cache->evict(cache->budget - size);
+
+    glyph_cache_t::entry_t* e = nullptr;
+    if (cache->psram) e = (glyph_cache_t::entry_t*)heap_alloc_psram(size);
+    if (!e)           e = (glyph_cache_t::entry_t*)heap_alloc(size);
+    if (!e) return nullptr;
+
+    memcpy(e->header, header, sizeof(e->header));
+    e->length = length;
+    e->gNum = gNum;
+    cache->insert(e);
+    cache->used += size;
+    return e->bitmap();
+  }
+
+  std::uint8_t* VLWfont::get_scratch(std::uint32_t length) const
+  {
+    if (_scratch_size < length)
+    {
+      if (_scratch) heap_free(_scratch);
+      _scratch = (std::uint8_t*)heap_alloc(length);
+      _scratch_size = _scratch ? length : 0;
+    }
+    return _scratch;
+  }
+
   bool VLWfont::getUnicodeIndex(std::uint16_t unicode, std::uint16_t *index) const
   {
     auto poi = std::lower_bound(gUnicode, &gUnicode[gCount], unicode);
@@ -729,18 +1207,26 @@ namespace lgfx
         metrics->x_advance = gxAdvance[gNum];
         metrics->x_offset  = gdX[gNum];
       } else {
-        auto file = _fontData;
+        std::uint32_t buffer[6];
+        // メトリクスの取得だけではビットマップを読まないため、キャッシュの統計・使用順には数えない
+        glyph_cache_t::entry_t* cached;
+        if (_fontMem) {
+          memcpy(buffer, &_fontMem[28 + gNum * 28], 24);
+        } else if (_glyph_cache && (cached = _glyph_cache->find(gNum))) {
+          memcpy(buffer, cached->header, 24);
+        } else {
+          auto file = _fontData;
 
-        file->preRead();
+          file->preRead();
 
-        file->seek(28 + gNum * 28);  // headerPtr
-        std::uint32_t buffer[6];
-        file->read((std::uint8_t*)buffer, 24);
+          file->seek(28 + gNum * 28);  // headerPtr
+          file->read((std::uint8_t*)buffer, 24);
+
+          file->postRead();
+        }
         metrics->width    = __builtin_bswap32(buffer[1]); // Width of glyph
         metrics->x_advance = __builtin_bswap32(buffer[2]); // xAdvance - to move x cursor
         metrics->x_offset  = (std::int32_t)((std::int8_t)__builtin_bswap32(buffer[4])); // x delta from cursor
-
-        file->postRead();
       }
       return true;
     }
@@ -755,6 +1241,9 @@ namespace lgfx
 
   bool VLWfont::loadFont(DataWrapper* data) {
     _fontData = data;
+    // メモリ上のデータであれば、グリフはコピーせずに直接参照する
+    data->seek(0);
+    _fontMem = data->getPointer();
     {
       std::uint32_t buf[6];
       data->read((std::uint8_t*)buf, 6 * 4); // 24 Byte read
@@ -847,13 +1336,17 @@ namespace lgfx
 
     std::uint32_t buffer[6] = {0};
     std::uint16_t gNum = 0;
+    std::uint8_t* pixel = nullptr;
 
     if (code == 0x20) {
       gNum = 0xFFFF;
       buffer[2] = __builtin_bswap32(this->spaceWidth);
     } else if (!this->getUnicodeIndex(code, &gNum)) {
       return 0;
-    } else {
+    } else if (this->_fontMem) {
+      memcpy(buffer, &this->_fontMem[28 + gNum * 28], 24);
+      pixel = const_cast<std::uint8_t*>(&this->_fontMem[this->gBitmap[gNum]]);
+    } else if (!(pixel = const_cast<std::uint8_t*>(cache_find(gNum, buffer)))) {
       file->preRead();
       file->seek(28 + gNum * 28);
       file->read((std::uint8_t*)buffer, 24);
@@ -871,10 +1364,12 @@ namespace lgfx
     std::int32_t yoffset = (this->maxAscent - dY);
 //      std::int32_t yoffset = (gfx->_font_metrics.y_offset) - dY;
 
-    std::uint8_t pbuffer[w * h];
-    std::uint8_t* pixel = pbuffer;
-    if (gNum != 0xFFFF) {
-      file->read(pixel, w * h);
+    // キャッシュに載らなかったビットマップはフォントが保持する作業バッファに読み込む
+    if (!pixel && gNum != 0xFFFF) {
+      pixel = cache_store(gNum, buffer, w * h);
+      if (!pixel && 0 < w && 0 < h) pixel = get_scratch(w * h);
+      if (pixel) file->read(pixel, w * h);
+      else w = 0;  // ビットマップを確保できない場合は背景のみ描画する
       file->postRead();
     }
 
@@ -1,6 +1,7 @@
 #ifndef LGFX_FONTS_HPP_
 #define LGFX_FONTS_HPP_
 
+#include <atomic>
 #include <cstdint>
 
 namespace lgfx
@@ -30,6 +31,7 @@ namespace lgfx
     , ft_bdf
     , ft_vlw
     , ft_u8g2
+    , ft_aa
     };
 
     virtual font_type_t getType(void) const { return font_type_t::ft_unknown; }
@@ -37,6 +39,11 @@ namespace lgfx
     virtual bool updateFontMetric(FontMetrics *metrics, std::uint16_t uniCode) const = 0;
     virtual bool unloadFont(void) { return false; }
     virtual std::size_t drawChar(LGFXBase* gfx, std::int32_t x, std::int32_t y, std::uint16_t c, const TextStyle* style) const = 0;
+
+  protected:
+    // IFont は LGFXBase の friend なので、派生フォントはこれらを経由して描画先の内部を使う
+    static bool isInsideClip(const LGFXBase* gfx, std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h);
+    static void writeRawColor(LGFXBase* gfx, std::uint32_t color, std::int32_t length);
   };
 
   struct BaseFont : public IFont {
@@ -151,6 +158,17 @@ namespace lgfx
 
   private:
     GFXglyph* getGlyph(std::uint16_t uniCode) const;
+    bool rangeSorted(void) const;
+
+    // getDefaultMetric と range の整列判定の結果を保持する。
+    // フォントは複数タスクから共有されるため、フラグと値を1語にまとめて fetch_or で公開する。
+    // (bit 0-7 : フラグ, bit 8-15 : glyph_ab, bit 16-23 : glyph_bb)
+    enum : std::uint32_t
+    { memo_metric  = 1
+    , memo_checked = 2
+    , memo_sorted  = 4
+    };
+    mutable std::atomic<std::uint32_t> _memo { 0 };
   };
 
 //----------------------------------------------------------------------------
@@ -187,9 +205,64 @@ namespace lgfx
     bool updateFontMetric(FontMetrics *metrics, std::uint16_t uniCode) const override;
     std::size_t drawChar(LGFXBase* gfx, std::int32_t x, std::int32_t y, std::uint16_t c, const TextStyle* style) const override;
 
+    // glyph index is built on first lookup (thread safe). release it to get the memory back (rebuilt on next use).
+    // releaseGlyphIndex must not be called while another task is drawing with this font.
+    bool buildGlyphIndex(void) const;
+    void releaseGlyphIndex(void) const;
+
   private:
+    struct glyph_index_t;
     const uint8_t* getGlyph(std::uint16_t encoding) const;
     const std::uint8_t* _font;
+    mutable std::atomic<glyph_index_t*> _index { nullptr };
+    mutable std::atomic<bool> _index_failed { false };
+  };
+
+//----------------------------------------------------------------------------
+// anti-aliased font (2bpp / 4bpp coverage, RLE)
+
+  struct AAglyph { // Data stored PER GLYPH
+    std::uint32_t bitmapOffset;     // Offset into AAfont->bitmap (RLE data)
+    std::uint16_t unicode;          // Glyph code (ascending order)
+    std::uint8_t  width, height;    // Bitmap dimensions in pixels
+    std::uint8_t  xAdvance;         // Distance to advance cursor (x axis)
+    std::int8_t   xOffset, yOffset; // Dist from cursor pos to UL corner
+  };
+
+  struct AAfont : public lgfx::IFont
+  { // Data stored for FONT AS A WHOLE:
+    const std::uint8_t *bitmap; // RLE coverage. 1 byte = (run length - 1) << bpp | level
+    const AAglyph *glyph;       // Glyph array
+    std::uint16_t glyph_num;    // Number of glyphs
+    std::uint8_t  bpp;          // bits per level (2 or 4)
+    std::uint8_t  yAdvance;     // Newline distance (y axis)
+    std::uint8_t  ascent;       // above baseline
+    std::uint8_t  descent;      // below baseline
+
+    constexpr AAfont ( const std::uint8_t *bitmap
+                     , const AAglyph *glyph
+                     , std::uint16_t glyph_num
+                     , std::uint8_t bpp
+                     , std::uint8_t yAdvance
+                     , std::uint8_t ascent
+                     , std::uint8_t descent
+                     )
+    : bitmap   (bitmap   )
+    , glyph    (glyph    )
+    , glyph_num(glyph_num)
+    , bpp      (bpp      )
+    , yAdvance (yAdvance )
+    , ascent   (ascent   )
+    , descent  (descent  )
+    {}
+
+    font_type_t getType(void) const override { return font_type_t::ft_aa; }
+    void getDefaultMetric(FontMetrics *metrics) const override;
+    bool updateFontMetric(FontMetrics *metrics, std::uint16_t uniCode) const override;
+    std::size_t drawChar(LGFXBase* gfx, std::int32_t x, std::int32_t y, std::uint16_t c, const TextStyle* style) const override;
+
+  private:
+    const AAglyph* getGlyph(std::uint16_t uniCode) const;
   };
 
 //----------------------------------------------------------------------------
@@ -218,6 +291,7 @@ namespace lgfx
     std::uint32_t* gBitmap   = nullptr;  //file pointer to greyscale bitmap
 
     DataWrapper* _fontData = nullptr;
+    const std::uint8_t* _fontMem = nullptr; // データがメモリ上にある場合 (配列・マップしたパーティション) はその先頭
     bool _fontLoaded = false; // Flags when a anti-aliased font is loaded
 
     font_type_t getType(void) const override { return ft_vlw; } 
@@ -235,6 +309,24 @@ namespace lgfx
     bool getUnicodeIndex(std::uint16_t unicode, std::uint16_t *index) const;
 
     bool loadFont(DataWrapper* data);
+
+    // glyph cache (LRU). bytes = 0 : disable.
+    void setGlyphCacheSize(std::uint32_t bytes, bool psram = false);
+    void clearGlyphCache(void);
+    std::uint32_t getGlyphCacheHits(void) const;
+    std::uint32_t getGlyphCacheMisses(void) const;
+
+  private:
+    struct glyph_cache_t;
+    glyph_cache_t* _glyph_cache = nullptr;
+
+    // キャッシュに載らないグリフのビットマップ読込み用。最大のグリフに合わせて拡張し、unloadFontまで保持する
+    mutable std::uint8_t* _scratch = nullptr;
+    mutable std::uint32_t _scratch_size = 0;
+    std::uint8_t* get_scratch(std::uint32_t length) const;
+
+    const std::uint8_t* cache_find(std::uint16_t gNum, std::uint32_t* header) const;
+    std::uint8_t* cache_store(std::uint16_t gNum, const std::uint32_t* header, std::uint32_t length) const;
   };
 }
 
@@ -63,6 +63,11 @@ Contributors:
 
 #endif
 
+#include "lgfx/LGFX_Ticker.hpp"         // scrolling message line (optional)
+#include "lgfx/LGFX_ImageCache.hpp"     // decoded image cache (optional)
+#include "lgfx/LGFX_QRCode.hpp"         // cached QR code (optional)
+#include "lgfx/LGFX_Snapshot.hpp"       // PNG snapshot / capture ring (optional)
+
 // ArduinoIDEで利用する場合、ボードマネージャで選択したボードに合うConfigが読み込まれます。
 // ESP-IDFやHarmonyで利用する場合は、#include<LovyanGFX.hpp> より前に #define LGFX_ボード名 の記述をしてください。
 // お使いのボードが対応機種にない場合、"config/LGFX_Config_Custom" をコピーしてプロジェクトフォルダに配置し、
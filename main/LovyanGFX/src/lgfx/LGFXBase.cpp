@@ -20,10 +20,12 @@ Contributors:
  [tobozo](https://github.com/tobozo)  
 /----------------------------------------------------------------------------*/
 #include "LGFXBase.hpp"
+#include "LGFX_Sprite.hpp"
 
 #include "utility/lgfx_tjpgd.h"    // JPEG decode support
+#include "utility/lgfx_jpg_parallel.hpp"  // JPEG parallel decode support
 #include "utility/lgfx_pngle.h"    // PNG decode support
-#include "utility/lgfx_qrcode.h"   // QR code support
+#include "LGFX_QRCode.hpp"         // QR code support
 
 #include <algorithm>
 #include <cmath>
@@ -1276,6 +1278,45 @@ namespace lgfx
     readRect_impl(x, y, w, h, dst, param);
   }
 
+  void LGFXBase::fill_rect_alpha(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, std::uint_fast8_t alpha, std::uint32_t rgb888)
+  {
+    _adjust_abs(x, w);
+    if (x < _clip_l) { w += x - _clip_l; x = _clip_l; }
+    if (w > _clip_r + 1 - x) w = _clip_r + 1 - x;
+    if (w < 1) return;
+
+    _adjust_abs(y, h);
+    if (y < _clip_t) { h += y - _clip_t; y = _clip_t; }
+    if (h > _clip_b + 1 - y) h = _clip_b + 1 - y;
+    if (h < 1) return;
+
+    std::uint_fast16_t a = alpha + 1;
+    std::uint_fast16_t na = 257 - a;
+    std::uint_fast16_t r = (rgb888 >> 16)        * a;
+    std::uint_fast16_t g = ((rgb888 >> 8) & 0xFF) * a;
+    std::uint_fast16_t b = (rgb888 & 0xFF)        * a;
+
+    // スタックを圧迫しないよう、固定長のバッファで行を分割して処理する
+    static constexpr std::int32_t chunk = 64;
+    bgr888_t buf[chunk];
+    startWrite();
+    do {
+      std::int32_t cx = 0;
+      do {
+        std::int32_t len = std::min(chunk, w - cx);
+        readRectRGB(x + cx, y, len, 1, buf);
+        for (std::int32_t i = 0; i < len; ++i) {
+          buf[i].r = (buf[i].r * na + r) >> 8;
+          buf[i].g = (buf[i].g * na + g) >> 8;
+          buf[i].b = (buf[i].b * na + b) >> 8;
+        }
+        pushImage(x + cx, y, len, 1, buf);
+      } while ((cx += chunk) < w);
+      ++y;
+    } while (--h);
+    endWrite();
+  }
+
   struct paint_point_t { std::int32_t lx,rx,y,oy; };
 
   static void paint_add_points(std::list<paint_point_t>& points, int lx, int rx, int y, int oy, bool* linebuf)
@@ -1562,6 +1603,10 @@ namespace lgfx
         }
 
         if (!_font->updateFontMetric(&_font_metrics, uniCode)) continue;
+        if (is_tabular(uniCode)) {
+          right = left += (int)(tabular_advance() * sx);
+          continue;
+        }
         if (left == 0 && right == 0 && _font_metrics.x_offset < 0) left = right = - (int)(_font_metrics.x_offset * sx);
         right = left + std::max<int>(_font_metrics.x_advance*sx, int(_font_metrics.width*sx) + int(_font_metrics.x_offset * sx));
         //right = left + (int)(std::max<int>(_font_metrics.x_advance, _font_metrics.width + _font_metrics.x_offset) * sx);
@@ -1570,6 +1615,44 @@ namespace lgfx
       return right;
     }
 
+    std::int32_t LGFXBase::tabular_advance(void)
+    {
+      if (_tabular_font != _font) {
+        _tabular_font = _font;
+        _tabular_advance = 0;
+        FontMetrics metrics = _font_metrics;
+        for (std::uint16_t c = '0'; c <= '9'; ++c) {
+          if (_font->updateFontMetric(&metrics, c) && _tabular_advance < metrics.x_advance) {
+            _tabular_advance = metrics.x_advance;
+          }
+        }
+      }
+      return _tabular_advance;
+    }
+
+    std::size_t LGFXBase::draw_char(std::int32_t x, std::int32_t y, std::uint16_t uniCode)
+    {
+      if (!is_tabular(uniCode)) return _font->drawChar(this, x, y, uniCode, &_text_style);
+
+      // 数字セルの中央にグリフを置き、セルの残りを背景色で埋める
+      FontMetrics metrics = _font_metrics;
+      if (!_font->updateFontMetric(&metrics, uniCode)) return 0;
+      std::int32_t cell = tabular_advance() * _text_style.size_x;
+      std::int32_t advance = metrics.x_advance * _text_style.size_x;
+      std::int32_t dx = (cell - advance) >> 1;
+      if (_text_style.fore_rgb888 != _text_style.back_rgb888) {
+        std::int32_t top = y + int(_font_metrics.y_offset * _text_style.size_y);
+        std::int32_t h = _font_metrics.height * _text_style.size_y;
+        std::int32_t r = dx + advance;
+        setColor(_text_style.back_rgb888);
+        if (dx > 0) writeFillRect(x, top, dx, h);
+        if (r < cell) writeFillRect(x + r, top, cell - r, h);
+      }
+      _font->drawChar(this, x + dx, y, uniCode, &_text_style);
+      if (_filled_x < x + cell) _filled_x = x + cell;
+      return cell;
+    }
+
 
     std::size_t LGFXBase::drawNumber(long long_num, std::int32_t poX, std::int32_t poY)
     {
@@ -1593,6 +1676,15 @@ namespace lgfx
 
 
     std::size_t LGFXBase::draw_string(const char *string, std::int32_t x, std::int32_t y, textdatum_t datum)
+    {
+      // tabular figures で背景を塗る場合は、固定幅のセルを含む文字列全体を一度に転送する
+      if (_text_style.tabular && _text_style.fore_rgb888 != _text_style.back_rgb888 && !hasPalette()) {
+        return draw_string_buffered(string, x, y, datum);
+      }
+      return draw_string_direct(string, x, y, datum);
+    }
+
+    std::size_t LGFXBase::draw_string_direct(const char *string, std::int32_t x, std::int32_t y, textdatum_t datum)
     {
       std::int16_t sumX = 0;
       std::int32_t cwidth = textWidth(string); // Find the pixel width of the string in the font
@@ -1609,7 +1701,7 @@ namespace lgfx
             if (uniCode < 0x20) break;
           }
           if (_font->updateFontMetric(&_font_metrics, uniCode)) {
-            if (_font_metrics.x_offset < 0) sumX = - _font_metrics.x_offset * _text_style.size_x;
+            if (_font_metrics.x_offset < 0 && !is_tabular(uniCode)) sumX = - _font_metrics.x_offset * _text_style.size_x;
             break;
           }
         } while (*++tmp);
@@ -1659,7 +1751,7 @@ namespace lgfx
             if (uniCode < 0x20) break;
           }
 //          sumX += (fpDrawChar)(this, x + sumX, y, uniCode, &_text_style, _font);
-          sumX += _font->drawChar(this, x + sumX, y, uniCode, &_text_style);
+          sumX += draw_char(x + sumX, y, uniCode);
         } while (*(++string));
       }
       this->endWrite();
@@ -1667,6 +1759,246 @@ namespace lgfx
       return sumX;
     }
 
+    std::size_t LGFXBase::draw_string_buffered(const char *string, std::int32_t x, std::int32_t y, textdatum_t datum)
+    {
+      // 背景色なし・パレットの場合は従来の描画を行う
+      if (_text_style.fore_rgb888 == _text_style.back_rgb888 || hasPalette() || !string || !string[0])
+      {
+        return draw_string_direct(string, x, y, datum);
+      }
+
+      std::int32_t cwidth = textWidth(string);
+      std::int32_t cheight = _font_metrics.height * _text_style.size_y;
+      std::int32_t w = std::max(cwidth, _padding_x);
+      if (w <= 0 || cheight <= 0) return 0;
+
+      // 文字列全体(パディング含む)の矩形を求める
+      std::int32_t bx = x;
+      std::int32_t tx = 0;
+      if (datum & top_center) {           // Horizontal: middle
+        bx -= w >> 1;
+        tx = (w >> 1) - (cwidth >> 1);
+      } else if (datum & top_right) {     // Horizontal: right
+        bx -= w;
+        tx = w - cwidth;
+      }
+      std::int32_t by = y;
+      if (datum & middle_left) {          // vertical: middle
+        by -= cheight >> 1;
+      } else if (datum & bottom_left) {   // vertical: bottom
+        by -= cheight;
+      } else if (datum & baseline_left) { // vertical: baseline
+        by -= (int)(_font_metrics.baseline * _text_style.size_y);
+      }
+
+      if (bx > _clip_r || by > _clip_b || bx + w <= _clip_l || by + cheight <= _clip_t) return cwidth;
+
+      // 描画先のバッファは使い回し、足りない場合だけ確保し直す
+      std::size_t len = (((w + 7) * getColorDepth()) >> 3) * cheight;
+      if (_string_buffer_len < len)
+      {
+        releaseStringBuffer();
+        _string_buffer = heap_alloc_dma(len);
+        if (!_string_buffer) return draw_string_direct(string, x, y, datum);
+        _string_buffer_len = len;
+      }
+      LGFX_Sprite sprite;
+      sprite.setBuffer(_string_buffer, w, cheight, getColorDepth());
+      sprite.setFont(_font);
+      sprite.setTextStyle(_text_style);
+      sprite.fillScreen(_text_style.back_rgb888);
+      std::size_t res = static_cast<LGFXBase&>(sprite).draw_string_direct(string, tx, 0, textdatum_t::top_left);
+
+      pixelcopy_t p(sprite.getBuffer(), getColorDepth(), sprite.getColorDepth(), false);
+      pushImage(bx, by, w, cheight, &p);
+      _filled_x = 0;
+      return res;
+    }
+
+    const std::uint32_t* LGFXBase::_get_blend_table(std::uint32_t fore_rgb888, std::uint32_t back_rgb888, std::uint_fast8_t bpp)
+    {
+      // 前回と同じ色・階調数・色変換なら作成済みのテーブルを返す
+      auto& t = _blend_table;
+      if (t.bpp == bpp && t.fore == fore_rgb888 && t.back == back_rgb888 && t.convert == _write_conv.convert_rgb888) return t.color;
+
+      std::uint32_t mask = (1 << bpp) - 1;
+      std::int32_t fore_r = (fore_rgb888 >> 16) & 0xFF;
+      std::int32_t fore_g = (fore_rgb888 >>  8) & 0xFF;
+      std::int32_t fore_b = (fore_rgb888      ) & 0xFF;
+      std::int32_t back_r = (back_rgb888 >> 16) & 0xFF;
+      std::int32_t back_g = (back_rgb888 >>  8) & 0xFF;
+      std::int32_t back_b = (back_rgb888      ) & 0xFF;
+      std::uint32_t i = 0;
+      do {
+        std::uint32_t a = mask - i;
+        t.color[i] = _write_conv.convert(color888( (fore_r * i + back_r * a) / mask
+                                                 , (fore_g * i + back_g * a) / mask
+                                                 , (fore_b * i + back_b * a) / mask));
+      } while (++i <= mask);
+      t.fore = fore_rgb888;
+      t.back = back_rgb888;
+      t.convert = _write_conv.convert_rgb888;
+      t.bpp = bpp;
+      return t.color;
+    }
+
+    // UTF-8の1文字分をまとめて復号する (decodeUTF8 と同じく21bitは非対応)
+    static std::uint16_t decode_utf8_char(std::uint_fast8_t c, const std::uint8_t*& p)
+    {
+      if ((c & 0xE0) == 0xC0 && p[0])
+      {
+        return (c & 0x1F) << 6 | (*p++ & 0x3F);
+      }
+      if ((c & 0xF0) == 0xE0 && p[0] && p[1])
+      {
+        std::uint16_t res = (c & 0x0F) << 12 | (p[0] & 0x3F) << 6 | (p[1] & 0x3F);
+        p += 2;
+        return res;
+      }
+      return c; // fall-back to extended ASCII
+    }
+
+    bool LGFXBase::layoutString(TextLayout* layout, const char *string)
+    {
+      layout->_count = 0;
+      layout->_width = 0;
+      if (!string) return false;
+
+      std::size_t len = strlen(string);
+      if (layout->_capacity < len)
+      {
+        layout->release();
+        layout->_glyphs = (TextLayout::glyph_t*)heap_alloc(len * sizeof(TextLayout::glyph_t));
+        if (!layout->_glyphs) return false;
+        layout->_capacity = len;
+      }
+
+      auto glyphs = layout->_glyphs;
+      std::size_t count = 0;
+      auto p = (const std::uint8_t*)string;
+      if (_text_style.utf8)
+      {
+        while (*p)
+        {
+          std::uint16_t uniCode = *p++;
+          if (uniCode >= 0x80) uniCode = decode_utf8_char(uniCode, p);
+          else if (uniCode < 0x20) continue;
+          glyphs[count++].code = uniCode;
+        }
+      }
+      else
+      {
+        while (*p) { glyphs[count++].code = *p++; }
+      }
+      layout->_count = count;
+      measure_layout(layout);
+      return true;
+    }
+
+    void LGFXBase::measure_layout(TextLayout* layout)
+    {
+      auto sx = _text_style.size_x;
+      auto glyphs = layout->_glyphs;
+      std::size_t count = layout->_count;
+      std::int32_t left = 0;
+      std::int32_t right = 0;
+      std::int32_t sumX = 0;
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        std::uint16_t uniCode = glyphs[i].code;
+        // フォントに無い文字も後で別のフォントで測り直せるよう、コードは残したまま幅0として扱う
+        glyphs[i].x = sumX;
+        glyphs[i].drawn = _font->updateFontMetric(&_font_metrics, uniCode);
+        if (!glyphs[i].drawn) continue;
+        if (is_tabular(uniCode)) {
+          std::int32_t cell = tabular_advance() * sx;
+          sumX += cell;
+          right = left += cell;
+          continue;
+        }
+        if (left == 0 && right == 0 && _font_metrics.x_offset < 0) sumX = left = right = - (int)(_font_metrics.x_offset * sx);
+        right = left + std::max<int>(_font_metrics.x_advance*sx, int(_font_metrics.width*sx) + int(_font_metrics.x_offset * sx));
+        left += (int)(_font_metrics.x_advance * sx);
+        glyphs[i].x = sumX;
+        sumX += (int)(_font_metrics.x_advance * sx);
+      }
+      layout->_width  = right;
+      layout->_height = _font_metrics.height * _text_style.size_y;
+      layout->_font   = _font;
+      layout->_size_x = _text_style.size_x;
+      layout->_size_y = _text_style.size_y;
+      layout->_tabular = _text_style.tabular;
+    }
+
+    std::size_t LGFXBase::drawLayout(TextLayout* layout, std::int32_t x, std::int32_t y, std::size_t first, std::size_t count)
+    {
+      // フォントや文字サイズが変更されていれば測り直す
+      if (layout->_font   != _font
+       || layout->_size_x != _text_style.size_x
+       || layout->_size_y != _text_style.size_y
+       || layout->_tabular != _text_style.tabular)
+      {
+        measure_layout(layout);
+      }
+      if (first >= layout->_count) return 0;
+      if (count > layout->_count - first) count = layout->_count - first;
+      if (!count) return 0;
+      bool whole = (first == 0 && count == layout->_count);
+
+      auto datum = _text_style.datum;
+      std::int32_t cwidth = layout->_width;
+      std::int32_t cheight = layout->_height;
+
+      if (datum & middle_left) {          // vertical: middle
+        y -= cheight >> 1;
+      } else if (datum & bottom_left) {   // vertical: bottom
+        y -= cheight;
+      } else if (datum & baseline_left) { // vertical: baseline
+        y -= (int)(_font_metrics.baseline * _text_style.size_y);
+      }
+
+      this->startWrite();
+      std::int32_t padx = _padding_x;
+      if (whole && (_text_style.fore_rgb888 != _text_style.back_rgb888) && (padx > cwidth)) {
+        this->setColor(_text_style.back_rgb888);
+        if (datum & top_center) {
+          auto halfcwidth = cwidth >> 1;
+          auto halfpadx = (padx >> 1);
+          this->writeFillRect(x - halfpadx, y, halfpadx - halfcwidth, cheight);
+          halfcwidth = cwidth - halfcwidth;
+          halfpadx = padx - halfpadx;
+          this->writeFillRect(x + halfcwidth, y, halfpadx - halfcwidth, cheight);
+        } else if (datum & top_right) {
+          this->writeFillRect(x - padx, y, padx - cwidth, cheight);
+        } else {
+          this->writeFillRect(x + cwidth, y, padx - cwidth, cheight);
+        }
+      }
+
+      if (datum & top_center) {           // Horizontal: middle
+        x -= cwidth >> 1;
+      } else if (datum & top_right) {     // Horizontal: right
+        x -= cwidth;
+      }
+
+      y -= int(_font_metrics.y_offset * _text_style.size_y);
+
+      auto glyphs = &layout->_glyphs[first];
+      _filled_x = whole ? 0 : x + glyphs[0].x;
+      std::size_t sumX = 0;
+      std::int32_t lead = -1;  // 最初に描画した文字の位置 (左にはみ出す文字の補正分)
+      do {
+        if (glyphs->drawn) {
+          if (lead < 0) lead = glyphs->x;
+          sumX += draw_char(x + glyphs->x, y, glyphs->code);
+        }
+        ++glyphs;
+      } while (--count);
+      this->endWrite();
+
+      return (whole && lead > 0) ? lead + sumX : sumX;
+    }
+
     std::size_t LGFXBase::write(std::uint8_t utf8)
     {
       if (utf8 == '\r') return 1;
@@ -1685,6 +2017,7 @@ namespace lgfx
 
         std::int32_t xo = _font_metrics.x_offset  * _text_style.size_x;
         std::int32_t w  = std::max(xo + _font_metrics.width * _text_style.size_x, _font_metrics.x_advance * _text_style.size_x);
+        if (is_tabular(uniCode)) { xo = 0; w = tabular_advance() * _text_style.size_x; }
         if (_textscroll || _textwrap_x) {
           std::int32_t llimit = _textscroll ? this->_sx : this->_clip_l;
           if (_cursor_x < llimit - xo) _cursor_x = llimit - xo;
@@ -1730,7 +2063,7 @@ namespace lgfx
         _cursor_y = y - ydiff;
         y -= int(_font_metrics.y_offset  * _text_style.size_y);
         //_cursor_x += (fpDrawChar)(this, _cursor_x, y, uniCode, &_text_style, _font);
-        _cursor_x += _font->drawChar(this, _cursor_x, y, uniCode, &_text_style);
+        _cursor_x += draw_char(_cursor_x, y, uniCode);
       }
 
       return 1;
@@ -1781,9 +2114,10 @@ namespace lgfx
 
     void LGFXBase::setFont(const IFont* font)
     {
-      _runtime_font.reset();
       if (font == nullptr) font = &fonts::Font0;
+      if (_runtime_font.get() != font) _runtime_font.reset();
       _font = font;
+      _tabular_font = nullptr;
       //_decoderState = utf8_decode_state_t::utf8_state0;
 
       font->getDefaultMetric(&_font_metrics);
@@ -1808,7 +2142,9 @@ namespace lgfx
       this->_runtime_font.reset(font);
 
       if (font->loadFont(&_font_data)) {
+        font->setGlyphCacheSize(_font_cache_size, _font_cache_psram);
         this->_font = font;
+        this->_tabular_font = nullptr;
         this->_font->getDefaultMetric(&this->_font_metrics);
         return true;
       } else {
@@ -1822,6 +2158,17 @@ namespace lgfx
       if (_runtime_font.get() != nullptr) { setFont(&fonts::Font0); }
     }
 
+    void LGFXBase::setFontCacheSize(std::uint32_t bytes, bool psram)
+    {
+      _font_cache_size = bytes;
+      _font_cache_psram = psram;
+      auto font = _runtime_font.get();
+      if (font && font->getType() == IFont::font_type_t::ft_vlw)
+      {
+        static_cast<VLWfont*>(font)->setGlyphCacheSize(bytes, psram);
+      }
+    }
+
     void LGFXBase::showFont(std::uint32_t td)
     {
       auto font = (const VLWfont*)this->_font;
@@ -1882,37 +2229,9 @@ namespace lgfx
 
 //----------------------------------------------------------------------------
     void LGFXBase::qrcode(const char *string, std::int32_t x, std::int32_t y, std::int32_t width, std::uint8_t version) {
-      if (width == -1) {
-        width = std::min(_width, _height) * 9 / 10;
-      }
-      if (x == -1 || y == -1) {
-        x = (_width - width) >> 1;
-        y = (_height- width) >> 1;
-      }
-
-      setColor(0xFFFFFFU);
-      startWrite();
-      writeFillRect(x, y, width, width);
-      for (; version <= 40; ++version) {
-        QRCode qrcode;
-        std::uint8_t qrcodeData[lgfx_qrcode_getBufferSize(version)];
-        if (0 != lgfx_qrcode_initText(&qrcode, qrcodeData, version, 0, string)) continue;
-        std::int_fast16_t thickness = width / qrcode.size;
-        if (!thickness) break;
-        std::int_fast16_t lineLength = qrcode.size * thickness;
-        std::int_fast16_t xOffset = x + ((width - lineLength) >> 1);
-        std::int_fast16_t yOffset = y + ((width - lineLength) >> 1);
-        setColor(0);
-        y = 0;
-        do {
-          x = 0;
-          do {
-            if (lgfx_qrcode_getModule(&qrcode, x, y)) writeFillRect(x * thickness + xOffset, y * thickness + yOffset, thickness, thickness);
-          } while (++x < qrcode.size);
-        } while (++y < qrcode.size);
-        break;
-      }
-      endWrite();
+      LGFX_QRCode qr;
+      qr.setText(string, version);
+      qr.draw(this, x, y, width);
     }
 //----------------------------------------------------------------------------
 
@@ -1922,7 +2241,7 @@ namespace lgfx
 
     bitmap_header_t bmpdata;
     if (!bmpdata.load_bmp_header(data)
-      || (bmpdata.biCompression > 3)) {
+      || !bmpdata.is_supported()) {
       return false;
     }
 
@@ -1937,6 +2256,7 @@ namespace lgfx
     std::int32_t flow = (h < 0) ? 1 : -1;
     if (h < 0) h = -h;
     else y += h - 1;
+    if (w <= 0 || h == 0) return true;
 
     argb8888_t *palette = nullptr;
     if (bpp <= 8) {
@@ -1947,10 +2267,22 @@ namespace lgfx
 
     data->seek(seekOffset);
 
-    auto dst_depth = this->_write_conv.depth;
+    // 複数行をまとめて読込み、1回のpushImageで送る。バッファはヒープから確保し上限を設ける
+    // (LcdTask のスタックは小さいため行バッファをスタックに置かない)
+    constexpr std::uint32_t max_buffer = 4096;
     std::uint32_t buffersize = ((w * bpp + 31) >> 5) << 2;  // readline 4Byte align.
-    std::uint8_t lineBuffer[buffersize + 4];
-    pixelcopy_t p(lineBuffer, dst_depth, (color_depth_t)bpp, this->_palette_count, palette);
+    std::uint32_t packed = (w * bpp + 7) >> 3;              // pushImage に渡す1行のバイト数
+    bool rle = (bmpdata.biCompression == 1 || bmpdata.biCompression == 2);
+    std::int32_t rows = std::min<std::int32_t>(h, std::max<std::uint32_t>(1, max_buffer / buffersize));
+    std::uint8_t* buffer;  // rows行分 + 作業用1行分 (RLE展開・上下反転用)
+    while (nullptr == (buffer = (std::uint8_t*)heap_alloc(buffersize * (rows + 1) + 4)) && rows > 1) rows >>= 1;
+    if (!buffer) {
+      if (palette) delete[] palette;
+      return false;
+    }
+
+    auto dst_depth = this->_write_conv.depth;
+    pixelcopy_t p(buffer, dst_depth, (color_depth_t)bpp, this->_palette_count, palette);
     p.no_convert = false;
     if (8 >= bpp && !this->_palette_count) {
       p.fp_copy = pixelcopy_t::get_fp_palettecopy<argb8888_t>(dst_depth);
@@ -1965,32 +2297,39 @@ namespace lgfx
     }
 
     this->startWrite(!data->hasParent());
-    if (bmpdata.biCompression == 1) {
-      do {
-        data->preRead();
-        bmpdata.load_bmp_rle8(data, lineBuffer, w);
-        data->postRead();
-        this->pushImage(x, y, w, 1, &p);
-        y += flow;
-      } while (--h);
-    } else
-    if (bmpdata.biCompression == 2) {
-      do {
-        data->preRead();
-        bmpdata.load_bmp_rle4(data, lineBuffer, w);
-        data->postRead();
-        this->pushImage(x, y, w, 1, &p);
-        y += flow;
-      } while (--h);
-    } else {
-      do {
-        data->preRead();
-        data->read(lineBuffer, buffersize);
-        data->postRead();
-        this->pushImage(x, y, w, 1, &p);
-        y += flow;
-      } while (--h);
-    }
+    auto line = &buffer[buffersize * rows];
+    do {
+      std::int32_t n = std::min(rows, h);
+      data->preRead();
+      if (rle) {
+        // 下から上へ並ぶ場合はブロック内で逆順の位置へ展開する
+        for (std::int32_t i = 0; i < n; ++i) {
+          if (bmpdata.biCompression == 1) bmpdata.load_bmp_rle8(data, line, w);
+          else                            bmpdata.load_bmp_rle4(data, line, w);
+          memcpy(&buffer[packed * (flow < 0 ? n - 1 - i : i)], line, packed);
+        }
+      } else {
+        data->read(buffer, buffersize * n);
+        if (flow < 0) { // 下から上へ並ぶ行をブロック内で上下反転する
+          for (std::int32_t i = 0, j = n - 1; i < j; ++i, --j) {
+            memcpy(line, &buffer[buffersize * i], buffersize);
+            memcpy(&buffer[buffersize * i], &buffer[buffersize * j], buffersize);
+            memcpy(&buffer[buffersize * j], line, buffersize);
+          }
+        }
+        if (packed != buffersize) { // 行末の4Byteアライン分を詰める
+          for (std::int32_t i = 1; i < n; ++i) {
+            memmove(&buffer[packed * i], &buffer[buffersize * i], packed);
+          }
+        }
+      }
+      data->postRead();
+      this->pushImage(x, (flow < 0) ? y - n + 1 : y, w, n, &p, true);
+      y += flow * n;
+      h -= n;
+    } while (h);
+    this->waitDMA();
+    heap_free(buffer);
     if (palette) delete[] palette;
     this->endWrite();
     return true;
@@ -2003,6 +2342,13 @@ namespace lgfx
     DataWrapper *data;
     LGFXBase *lgfx;
     pixelcopy_t *pc;
+    // pipeline mode
+    std::uint8_t *band[2];    // MCU1行分の出力先 (描画先の形式)
+    std::uint_fast8_t band_index;
+    std::int32_t band_width;
+    pixelcopy_t *band_pc;
+    // parallel mode
+    pixelcopy_t *worker_pc;   // ワーカー毎の変換
   };
 
   static std::uint32_t jpg_read_data(lgfxJdec  *decoder, std::uint8_t *buf, std::uint32_t len) {
@@ -2032,10 +2378,66 @@ namespace lgfx
     return 1;
   }
 
+  // MCUを描画先の形式でMCU1行分のバッファへ変換し、行が揃ったらDMAで転送する。
+  // 転送中はもう一方のバッファへ次の行をデコードする。
+  static std::uint32_t jpg_push_band(lgfxJdec *decoder, void *bitmap, JRECT *rect) {
+    draw_jpg_info_t *jpeg = static_cast<draw_jpg_info_t*>(decoder->device);
+    auto pc = jpeg->pc;
+    auto band = jpeg->band[jpeg->band_index];
+    std::int32_t w = rect->right  - rect->left + 1;
+    std::int32_t h = rect->bottom - rect->top  + 1;
+    std::int32_t bw = jpeg->band_width;
+    pc->src_data = bitmap;
+    pc->src_width = w;
+    for (std::int32_t i = 0; i < h; ++i) {
+      pc->src_x32 = 0;
+      pc->src_y32 = i << FP_SCALE;
+      std::int32_t index = i * bw + rect->left;
+      pc->fp_copy(band, index, index + w, pc);
+    }
+    if ((std::int32_t)rect->right + 1 < bw) return 1;
+
+    jpeg->band_pc->src_data = band;
+    jpeg->lgfx->pushImage( jpeg->x
+                         , jpeg->y + rect->top
+                         , bw
+                         , h
+                         , jpeg->band_pc
+                         , true);
+    jpeg->band_index ^= 1;
+    return 1;
+  }
+
+  // 並列デコードのワーカーが、MCUを描画先の形式でバンドへ変換する
+  static void jpg_parallel_convert(void* param, int worker, void* bitmap, const JRECT* rect, std::uint8_t* dst, std::int32_t stride) {
+    auto jpeg = static_cast<draw_jpg_info_t*>(param);
+    auto pc = &jpeg->worker_pc[worker];
+    std::int32_t w = rect->right  - rect->left + 1;
+    std::int32_t h = rect->bottom - rect->top  + 1;
+    pc->src_data = bitmap;
+    pc->src_width = w;
+    for (std::int32_t i = 0; i < h; ++i) {
+      pc->src_x32 = 0;
+      pc->src_y32 = i << FP_SCALE;
+      std::int32_t index = i * stride;
+      pc->fp_copy(dst, index, index + w, pc);
+    }
+  }
+
+  // 揃ったバンドを走査線順に転送する
+  static bool jpg_parallel_output(void* param, std::uint8_t* band, std::int32_t y, std::int32_t w, std::int32_t h) {
+    auto jpeg = static_cast<draw_jpg_info_t*>(param);
+    jpeg->band_pc->src_data = band;
+    jpeg->lgfx->pushImage(jpeg->x, jpeg->y + y, w, h, jpeg->band_pc, true);
+    return true;
+  }
+
   bool LGFXBase::draw_jpg(DataWrapper* data, std::int32_t x, std::int32_t y, std::int32_t maxWidth, std::int32_t maxHeight, std::int32_t offX, std::int32_t offY, jpeg_div::jpeg_div_t scale)
   {
     draw_jpg_info_t jpeg;
-    pixelcopy_t pc(nullptr, this->getColorDepth(), bgr888_t::depth, this->hasPalette());
+    // 描画先が16bppならデコーダから swap565 で受け取り、変換を省く
+    bool swap565 = (_jpg_profile & jpeg_profile::JPEG_PROFILE_SWAP565) && this->getColorDepth() == rgb565_2Byte && !this->hasPalette();
+    pixelcopy_t pc(nullptr, this->getColorDepth(), swap565 ? swap565_t::depth : bgr888_t::depth, this->hasPalette());
     jpeg.pc = &pc;
     jpeg.lgfx = this;
     jpeg.data = data;
@@ -2045,7 +2447,11 @@ namespace lgfx
     //TJpgD jpegdec;
     lgfxJdec jpegdec;
 
-    static constexpr std::uint16_t sz_pool = 3100;
+    // 並列モードではデータを直接参照する
+    const std::uint8_t* mem = _jpg_parallel ? data->getPointer() : nullptr;
+    std::uint32_t mem_len = mem ? data->getLength() : 0;
+
+    std::uint16_t sz_pool = (_jpg_profile & jpeg_profile::JPEG_PROFILE_LARGE_POOL) ? JD_SZWORK + JD_SZBUF * 8 : 3100;
     std::uint8_t *pool = (std::uint8_t*)heap_alloc_dma(sz_pool);
     if (!pool) {
 //        ESP_LOGE("LGFX","memory allocation failure");
@@ -2059,6 +2465,8 @@ namespace lgfx
       heap_free(pool);
       return false;
     }
+    jpegdec.format = swap565 ? 2 : 0;
+    jpegdec.tblclip = (_jpg_profile & jpeg_profile::JPEG_PROFILE_TBLCLIP) ? 1 : 0;
 
     if (!maxWidth) maxWidth = this->width();
     auto cl = this->_clip_l;
@@ -2072,10 +2480,62 @@ namespace lgfx
     auto cb = this->_clip_b + 1;
     if (maxHeight > (cb - y)) maxHeight = (cb - y);
 
+    pixelcopy_t band_pc;
+    jpeg.band[0] = jpeg.band[1] = nullptr;
+
+    // 並列モード : DRIで区切られたMCU行を2つのタスクで交互にデコードし、走査線順に転送する
+    jpg_parallel_t parallel;
+    pixelcopy_t worker_pc[jpg_parallel_t::worker_count];
+    bool use_parallel = false;
+    if (mem_len && maxWidth > 0 && maxHeight > 0 && !this->hasPalette() && _write_conv.bytes) {
+      use_parallel = parallel.setup(&jpegdec, mem, mem_len, scale, _write_conv.bytes);
+      if (use_parallel) {
+        for (auto& wpc : worker_pc) wpc = pc;
+        jpeg.worker_pc = worker_pc;
+        band_pc = pixelcopy_t(nullptr, this->getColorDepth(), this->getColorDepth());
+        jpeg.band_pc = &band_pc;
+      }
+    }
+
+    // パイプラインモード : 描画先の形式のMCU行バッファを2つ用意し、デコードとDMA転送を並行させる
+    // (データがSPIバスを共有する場合は読み込み時にバスを解放する必要があるため使用しない)
+    if (!use_parallel && _jpg_pipeline && maxWidth > 0 && maxHeight > 0 && !data->hasParent() && !this->hasPalette() && _write_conv.bytes) {
+      jpeg.band_index = 0;
+      jpeg.band_width = jpegdec.width >> scale;
+      std::size_t len = jpeg.band_width * ((jpegdec.msy << 3) >> scale) * _write_conv.bytes;
+      jpeg.band[0] = (std::uint8_t*)heap_alloc_dma(len);
+      jpeg.band[1] = (std::uint8_t*)heap_alloc_dma(len);
+      if (!jpeg.band[0] || !jpeg.band[1]) {
+        if (jpeg.band[0]) heap_free(jpeg.band[0]);
+        if (jpeg.band[1]) heap_free(jpeg.band[1]);
+        jpeg.band[0] = jpeg.band[1] = nullptr;
+      } else {
+        band_pc = pixelcopy_t(nullptr, this->getColorDepth(), this->getColorDepth());
+        jpeg.band_pc = &band_pc;
+      }
+    }
+
     if (maxWidth > 0 && maxHeight > 0) {
       this->setClipRect(x, y, maxWidth, maxHeight);
       this->startWrite(!data->hasParent());
-      jres = lgfx_jd_decomp(&jpegdec, jpg_push_image, scale);
+      if (use_parallel) {
+        jres = parallel.decode(jpg_parallel_convert, jpg_parallel_output, &jpeg);
+        this->waitDMA();
+        if (jres == JDR_MEM1) { // タスクを生成できなかった場合は先頭から通常のデコードを行う
+          PointerWrapper rewind;
+          rewind.set(mem, mem_len);
+          jpeg.data = &rewind;
+          jres = lgfx_jd_prepare(&jpegdec, jpg_read_data, pool, sz_pool, &jpeg);
+          if (jres == JDR_OK) {
+            jpegdec.format = swap565 ? 2 : 0;
+            jpegdec.tblclip = (_jpg_profile & jpeg_profile::JPEG_PROFILE_TBLCLIP) ? 1 : 0;
+            jres = lgfx_jd_decomp(&jpegdec, jpg_push_image, scale);
+          }
+        }
+      } else {
+        jres = lgfx_jd_decomp(&jpegdec, jpeg.band[0] ? jpg_push_band : jpg_push_image, scale);
+        if (jpeg.band[0]) this->waitDMA();
+      }
 
       this->_clip_l = cl;
       this->_clip_t = ct;
@@ -2083,6 +2543,10 @@ namespace lgfx
       this->_clip_b = cb-1;
       this->endWrite();
     }
+    if (jpeg.band[0]) {
+      heap_free(jpeg.band[0]);
+      heap_free(jpeg.band[1]);
+    }
     heap_free(pool);
 
     if (jres != JDR_OK) {
@@ -2108,8 +2572,32 @@ namespace lgfx
     std::uint32_t last_y;
     std::int32_t scale_y0;
     std::int32_t scale_y1;
+    bgr888_t* palette;            // ライン出力用 (パレット256色 + 透過フラグ256個)
+    std::uint8_t* palette_transp;
+    std::uint8_t row_bytes;       // ライン出力時の1画素のバイト数 (0:ライン出力しない)
+    bool row_ready;
+    bool row_transp;              // 透過画素を含み得る
+    bool line_dma;                // lineBuffer がDMA可能なメモリにある
+    bgr888_t transp_color;        // color type 2 の tRNS
+    pngle_arena_t* arena;
   };
 
+  // アリーナから確保し、入らなければヒープから確保する
+  static void* png_alloc(png_file_decoder_t *p, std::size_t size, bool dma)
+  {
+    void* res = lgfx_pngle_arena_alloc(p->arena, size);
+    if (res) return res;
+    return dma ? heap_alloc_dma(size) : heap_alloc(size);
+  }
+
+  static void png_free(png_file_decoder_t *p, void* buf)
+  {
+    auto b = (std::uint8_t*)buf;
+    auto a = p->arena;
+    if (a->buf <= b && b < a->buf + a->size) return;
+    heap_free(buf);
+  }
+
   static bool png_ypos_update(png_file_decoder_t *p, std::uint32_t y)
   {
     p->scale_y0 = ceil( y      * p->scale) - p->offY;
@@ -2123,7 +2611,7 @@ namespace lgfx
   {
     std::int32_t h = p->scale_y1 - p->scale_y0;
     if (0 < h)
-      p->lgfx->pushImage(p->x, p->y + p->scale_y0, p->maxWidth, h, p->pc, true);
+      p->lgfx->pushImage(p->x, p->y + p->scale_y0, p->maxWidth, h, p->pc, p->line_dma || !p->pc->no_convert);
   }
 
   static void png_prepare_line(png_file_decoder_t *p, std::uint32_t y)
@@ -2242,6 +2730,67 @@ namespace lgfx
     }
   }
 
+  // 最初のライン到着時に PLTE / tRNS を取り込む (IHDR 時点では未到着のため)
+  static void png_row_setup(png_file_decoder_t *p, pngle_t *pngle)
+  {
+    p->row_ready = true;
+    std::size_t n_trans;
+    auto trans = lgfx_pngle_get_trans_palette(pngle, &n_trans);
+    if (p->palette) {
+      std::size_t n_pal;
+      auto pal = lgfx_pngle_get_palette(pngle, &n_pal);
+      memset((void*)p->palette, 0, sizeof(bgr888_t) * 256 + 256);
+      memcpy(p->palette, pal, n_pal * 3);
+      for (std::size_t i = 0; i < n_trans; ++i) {
+        if (trans[i] == 0) { p->palette_transp[i] = 1; p->row_transp = true; }
+      }
+    } else if (n_trans == 1 && !(trans[0] | trans[2] | trans[4])) {
+      p->transp_color.set(trans[1], trans[3], trans[5]);
+      p->row_transp = true;
+    }
+  }
+
+  static void png_draw_row_callback(pngle_t *pngle, std::uint32_t y, const std::uint8_t* row, std::uint32_t)
+  {
+    auto p = (png_file_decoder_t*)lgfx_pngle_get_user_data(pngle);
+
+    std::int32_t t = y - p->offY;
+    if (t < 0 || t >= p->maxHeight) return;
+
+    if (!p->row_ready) png_row_setup(p, pngle);
+
+    auto pc = p->pc;
+    bool use_dma = !pc->no_convert;  // 無変換の場合はpngle側のバッファを直接送ることになるためDMAを使わない
+    std::uint_fast8_t bytes = p->row_bytes;
+    auto src = &row[p->offX * bytes];
+    std::int32_t w = p->maxWidth;
+    if (!p->row_transp) {
+      pc->src_data = src;
+      p->lgfx->pushImage(p->x, p->y + t, w, 1, pc, use_dma);
+      return;
+    }
+
+    // 透過画素を除いた区間ごとに出力する
+    auto transp = p->palette_transp;
+    auto tc = p->transp_color;
+    auto is_transp = [transp, tc, bytes, src](std::int32_t i)
+    {
+      if (transp) return transp[src[i]] != 0;
+      auto s = &src[i * bytes];
+      return s[0] == tc.r && s[1] == tc.g && s[2] == tc.b;
+    };
+    std::int32_t i = 0;
+    do {
+      while (i < w && is_transp(i)) ++i;
+      std::int32_t l = i;
+      while (i < w && !is_transp(i)) ++i;
+      if (l < i) {
+        pc->src_data = &src[l * bytes];
+        p->lgfx->pushImage(p->x + l, p->y + t, i - l, 1, pc, use_dma);
+      }
+    } while (i < w);
+  }
+
   static void png_init_callback(pngle_t *pngle, std::uint32_t w, std::uint32_t h, uint_fast8_t hasTransparent)
   {
 //    auto ihdr = lgfx_pngle_get_ihdr(pngle);
@@ -2264,7 +2813,12 @@ namespace lgfx
     if (p->offY < 0) { p->offY = 0; }
 
     if (hasTransparent) { // need pixel read ?
-      p->lineBuffer = (bgr888_t*)heap_alloc_dma(sizeof(bgr888_t) * p->maxWidth * ceil(p->scale));
+      std::size_t len = sizeof(bgr888_t) * p->maxWidth * ceil(p->scale);
+      p->lineBuffer = (bgr888_t*)lgfx_pngle_arena_alloc(p->arena, len);
+      if (!p->lineBuffer) {
+        p->lineBuffer = (bgr888_t*)heap_alloc_dma(len);
+        p->line_dma = true;
+      }
       p->pc->src_data = p->lineBuffer;
       png_prepare_line(p, 0);
       lgfx_pngle_set_done_callback(pngle, png_done_callback);
@@ -2275,6 +2829,27 @@ namespace lgfx
         lgfx_pngle_set_draw_callback(pngle, png_draw_alpha_scale_callback);
       }
     } else {
+      auto ihdr = lgfx_pngle_get_ihdr(pngle);
+      if (p->scale == 1.0 && ihdr->depth == 8 && !ihdr->interlace
+       && (ihdr->color_type == 2 || ihdr->color_type == 3)
+       && !p->lgfx->hasPalette() && p->lgfx->getColorDepth() >= 8) {
+        // 8bit RGB / 8bit パレットはライン単位でpushImageする
+        if (ihdr->color_type == 3) {
+          p->palette = (bgr888_t*)png_alloc(p, sizeof(bgr888_t) * 256 + 256, false);
+          if (p->palette) {
+            p->palette_transp = (std::uint8_t*)&p->palette[256];
+            *p->pc = pixelcopy_t(nullptr, p->lgfx->getColorDepth(), rgb332_1Byte, false, p->palette);
+            p->pc->no_convert = false;
+            p->row_bytes = 1;
+          }
+        } else {
+          p->row_bytes = 3;
+        }
+        if (p->row_bytes) {
+          lgfx_pngle_set_row_callback(pngle, png_draw_row_callback);
+          return;
+        }
+      }
       if (p->scale == 1.0) {
         lgfx_pngle_set_draw_callback(pngle, png_draw_normal_callback);
       } else {
@@ -2314,44 +2889,67 @@ namespace lgfx
     png.scale = scale;
     png.lgfx = this;
     png.lineBuffer = nullptr;
+    png.palette = nullptr;
+    png.palette_transp = nullptr;
+    png.row_bytes = 0;
+    png.row_ready = false;
+    png.row_transp = false;
+    png.line_dma = false;
 
     pixelcopy_t pc(nullptr, this->getColorDepth(), bgr888_t::depth, this->_palette_count);
     png.pc = &pc;
 
-    pngle_t *pngle = lgfx_pngle_new();
+    // アリーナ未指定でも必要量の計測のため同じ経路を通す (全てヒープから確保される)
+    pngle_arena_t arena;
+    lgfx_pngle_arena_init(&arena, _png_arena, _png_arena_size);
+    png.arena = &arena;
+    pngle_t *pngle = lgfx_pngle_new_arena(&arena);
+    if (!pngle) return false;
 
     lgfx_pngle_set_user_data(pngle, &png);
 
     lgfx_pngle_set_init_callback(pngle, png_init_callback);
 
-    // Feed data to pngle
-    std::uint8_t buf[512];
-    int remain = 0;
-    int len;
     bool res = true;
 
-    this->startWrite(!data->hasParent());
-    while (0 < (len = data->read(buf + remain, sizeof(buf) - remain))) {
-      data->postRead();
+    // メモリ上のデータ (配列・マップしたパーティション) はバッファへコピーせず直接渡す
+    auto mem = data->getPointer();
+    std::uint32_t mem_len = mem ? data->getLength() : 0;
+    if (mem_len) {
+      this->startWrite();
+      res = (0 <= lgfx_pngle_feed(pngle, mem, mem_len));
+      this->endWrite();
+    } else {
+      // Feed data to pngle
+      std::uint8_t buf[512];
+      int remain = 0;
+      int len;
+
+      this->startWrite(!data->hasParent());
+      while (0 < (len = data->read(buf + remain, sizeof(buf) - remain))) {
+        data->postRead();
 
-      int fed = lgfx_pngle_feed(pngle, buf, remain + len);
+        int fed = lgfx_pngle_feed(pngle, buf, remain + len);
 
-      if (fed < 0) {
+        if (fed < 0) {
 //ESP_LOGE("LGFX", "[pngle error] %s", lgfx_pngle_error(pngle));
-        res = false;
-        break;
-      }
+          res = false;
+          break;
+        }
 
-      remain = remain + len - fed;
-      if (remain > 0) memmove(buf, buf + fed, remain);
-      data->preRead();
+        remain = remain + len - fed;
+        if (remain > 0) memmove(buf, buf + fed, remain);
+        data->preRead();
+      }
+      this->endWrite();
     }
-    this->endWrite();
-    if (png.lineBuffer) {
+    if (png.lineBuffer || png.palette) {
       this->waitDMA();
-      heap_free(png.lineBuffer);
+      if (png.lineBuffer) png_free(&png, png.lineBuffer);
+      if (png.palette) png_free(&png, png.palette);
     }
     lgfx_pngle_destroy(pngle);
+    if (_png_arena_peak < arena.peak) _png_arena_peak = arena.peak;
     return res;
   }
 }
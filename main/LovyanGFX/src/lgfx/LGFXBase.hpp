@@ -32,6 +32,47 @@ Contributors:
 namespace lgfx
 {
   class LGFX_Sprite;
+  class LGFXBase;
+
+  /// decoded and measured string. see LGFXBase::layoutString / drawLayout
+  struct TextLayout
+  {
+    struct glyph_t
+    {
+      std::uint16_t code;  // Unicode
+      bool          drawn; // 現在のフォントに含まれる (含まれない文字は描画時に読み飛ばす)
+      std::int32_t  x;     // 文字列左端からの描画位置
+    };
+
+    TextLayout() = default;
+    TextLayout(const TextLayout&) = delete;
+    TextLayout& operator=(const TextLayout&) = delete;
+    ~TextLayout() { release(); }
+
+    void release(void)
+    {
+      if (_glyphs) { heap_free(_glyphs); _glyphs = nullptr; }
+      _count = _capacity = 0;
+      _width = 0;
+    }
+
+    std::size_t length(void) const { return _count; }
+    const glyph_t* glyphs(void) const { return _glyphs; }
+    std::int32_t width(void) const { return _width; }
+    std::int32_t height(void) const { return _height; }
+
+  private:
+    friend LGFXBase;
+    glyph_t* _glyphs = nullptr;
+    std::size_t _count = 0;
+    std::size_t _capacity = 0;
+    std::int32_t _width = 0;
+    std::int32_t _height = 0;
+    const IFont* _font = nullptr;
+    float _size_x = 0;
+    float _size_y = 0;
+    bool _tabular = false;
+  };
 
   class LGFXBase
 #if defined (ARDUINO)
@@ -42,7 +83,7 @@ namespace lgfx
   friend IFont;
   public:
     LGFXBase() {}
-    virtual ~LGFXBase() {}
+    virtual ~LGFXBase() { releaseStringBuffer(); }
 
 // color param format:
 // rgb888 : std::uint32_t
@@ -377,6 +418,10 @@ namespace lgfx
     void scroll(std::int_fast16_t dx, std::int_fast16_t dy = 0);
     void copyRect(std::int32_t dst_x, std::int32_t dst_y, std::int32_t w, std::int32_t h, std::int32_t src_x, std::int32_t src_y);
 
+    // 既存の描画内容に color を alpha(0~255) の比率で重ねる。読出し可能な描画先(SPI読出し対応パネル・RAMシャドウ・スプライト)で使用する
+    template<typename T>
+    void fillRectAlpha(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, std::uint8_t alpha, const T& color) { fill_rect_alpha(x, y, w, h, alpha, convert_to_rgb888(color)); }
+
 
     [[deprecated("use IFont")]]
     void setCursor( std::int32_t x, std::int32_t y, std::uint8_t font) { _filled_x = 0; _cursor_x = x; _cursor_y = y; setFont(fontdata[font]); }
@@ -396,6 +441,9 @@ namespace lgfx
     textdatum_t getTextDatum(void) const { return _text_style.datum; }
     void setTextPadding(std::uint32_t padding_x) { _padding_x = padding_x; }
     std::uint32_t getTextPadding(void) const { return _padding_x; }
+    // 数字と空白を最大の数字幅のセルに描画する。背景色がある場合、drawString は文字列全体を一度に転送する。
+    void setTextTabular(bool tabular) { _text_style.tabular = tabular; }
+    bool getTextTabular(void) const { return _text_style.tabular; }
     void setTextWrap( bool wrapX, bool wrapY = false) { _textwrap_x = wrapX; _textwrap_y = wrapY; }
     void setTextScroll(bool scroll) { _textscroll = scroll; if (_cursor_x < this->_sx) { _cursor_x = this->_sx; } if (_cursor_y < this->_sy) { _cursor_y = this->_sy; } }
 
@@ -430,6 +478,16 @@ namespace lgfx
     inline std::size_t drawString(const char *string, std::int32_t x, std::int32_t y, const IFont* font) { setFont(font          ); return draw_string(string, x, y, _text_style.datum); }
     inline std::size_t drawString(const char *string, std::int32_t x, std::int32_t y                   ) {                          return draw_string(string, x, y, _text_style.datum); }
 
+    /// rasterize the whole string off-screen, then send it with one pushImage (background color required)
+    inline std::size_t drawStringBuffered(const char *string, std::int32_t x, std::int32_t y) { return draw_string_buffered(string, x, y, _text_style.datum); }
+    /// the buffer used by drawStringBuffered grows on demand and is kept until this is called
+    void releaseStringBuffer(void) { if (_string_buffer) { heap_free(_string_buffer); _string_buffer = nullptr; } _string_buffer_len = 0; }
+
+    /// decode (UTF-8) and measure the string once. draw it with drawLayout.
+    bool layoutString(TextLayout* layout, const char *string);
+    /// draw the laid out string (all glyphs, or count glyphs from first for partial redraw)
+    std::size_t drawLayout(TextLayout* layout, std::int32_t x, std::int32_t y, std::size_t first = 0, std::size_t count = SIZE_MAX);
+
     [[deprecated("use IFont")]]
     inline std::size_t drawNumber(long long_num, std::int32_t poX, std::int32_t poY, std::uint8_t font) { setFont(fontdata[font]); return drawNumber(long_num, poX, poY); }
     inline std::size_t drawNumber(long long_num, std::int32_t poX, std::int32_t poY, const IFont* font) { setFont(font          ); return drawNumber(long_num, poX, poY); }
@@ -447,6 +505,7 @@ namespace lgfx
     inline std::int32_t textWidth(const String& string) { return textWidth(string.c_str()); }
 
     inline std::size_t drawString(const String& string, std::int32_t x, std::int32_t y                   ) {                          return draw_string(string.c_str(), x, y, _text_style.datum); }
+    inline std::size_t drawStringBuffered(const String& string, std::int32_t x, std::int32_t y) { return draw_string_buffered(string.c_str(), x, y, _text_style.datum); }
     inline std::size_t drawString(const String& string, std::int32_t x, std::int32_t y, std::uint8_t font) { setFont(fontdata[font]); return draw_string(string.c_str(), x, y, _text_style.datum); }
 
     [[deprecated("use setTextDatum() and drawString()")]] inline std::size_t drawCentreString(const String& string, std::int32_t x, std::int32_t y, std::uint8_t font) { setFont(fontdata[font]); return draw_string(string.c_str(), x, y, textdatum_t::top_center); }
@@ -504,6 +563,9 @@ namespace lgfx
     /// unload VLW font
     void unloadFont(void);
 
+    /// VLW font glyph cache size (bytes). 0 : disable
+    void setFontCacheSize(std::uint32_t bytes, bool psram = false);
+
     /// show VLW font
     void showFont(std::uint32_t td);
 
@@ -516,6 +578,7 @@ namespace lgfx
     std::int32_t _get_text_filled_x(void) const { return _filled_x; }
     void _set_text_filled_x(std::int32_t x) { _filled_x = x; }
     FontMetrics _get_font_metrics(void) const { return _font_metrics; }
+    const std::uint32_t* _get_blend_table(std::uint32_t fore_rgb888, std::uint32_t back_rgb888, std::uint_fast8_t bpp);
 
 //----------------------------------------------------------------------------
 // print & text support
@@ -595,9 +658,23 @@ namespace lgfx
       return this->draw_png(&data, x, y, maxWidth, maxHeight, offX, offY, scale);
     }
 
-    inline void drawBmp(DataWrapper *data, std::int32_t x=0, std::int32_t y=0) {
-      this->draw_bmp(data, x, y);
+    inline bool drawBmp(DataWrapper *data, std::int32_t x=0, std::int32_t y=0) {
+      return this->draw_bmp(data, x, y);
     }
+    // true : デコードしたMCU行を描画先の形式でバッファし、DMA転送と次の行のデコードを並行させる (MCU行2本分のDMAメモリを使用)
+    void setJpgPipeline(bool enable) { _jpg_pipeline = enable; }
+    bool getJpgPipeline(void) const { return _jpg_pipeline; }
+    // true : 再開マーカー(DRI)を持つメモリ上のJPEGを、2つのタスク(ESP32では各コア)で分担してデコードする
+    void setJpgParallel(bool enable) { _jpg_parallel = enable; }
+    bool getJpgParallel(void) const { return _jpg_parallel; }
+    // JPEGデコードの設定 (jpeg_profile_t の組合せ)
+    void setJpgProfile(std::uint8_t profile) { _jpg_profile = profile; }
+    std::uint8_t getJpgProfile(void) const { return _jpg_profile; }
+    // PNGデコードのワーク領域 (静的配列やPSRAM)。nullptr の場合は従来通りヒープから確保する
+    // 足りない分はヒープで補う。getPngArenaPeak() で必要なサイズを確認できる (未指定時も計測する)
+    void setPngArena(void* buf, std::size_t size) { _png_arena = buf; _png_arena_size = size; _png_arena_peak = 0; }
+    std::size_t getPngArenaPeak(void) const { return _png_arena_peak; }
+
     inline bool drawJpg(DataWrapper *data, std::int32_t x=0, std::int32_t y=0, std::int32_t maxWidth=0, std::int32_t maxHeight=0, std::int32_t offX=0, std::int32_t offY=0, jpeg_div::jpeg_div_t scale=jpeg_div::jpeg_div_t::JPEG_DIV_NONE) {
       return this->draw_jpg(data, x, y, maxWidth, maxHeight, offX, offY, scale);
     }
@@ -662,6 +739,18 @@ namespace lgfx
     std::int32_t _cursor_y = 0;
     std::int32_t _filled_x = 0;  // print filled position
     std::int32_t _padding_x = 0;
+    void* _string_buffer = nullptr;       // drawStringBuffered の描画先
+    std::size_t _string_buffer_len = 0;
+    const IFont* _tabular_font = nullptr;  // _tabular_advance を求めたフォント
+    std::int32_t _tabular_advance = 0;     // 数字の最大送り幅 (font unit)
+    struct blend_table_t
+    {
+      std::uint32_t fore = 0;
+      std::uint32_t back = 0;
+      std::uint32_t (*convert)(std::uint32_t) = nullptr;  // 作成時の色変換 (色深度が変わったら作り直す)
+      std::uint8_t bpp = 0;
+      std::uint32_t color[16];
+    } _blend_table;                        // AAfont の階調ごとの色
 
     TextStyle _text_style;
     FontMetrics _font_metrics = { 6, 6, 0, 8, 8, 0, 7 }; // Font0 Metric
@@ -669,10 +758,18 @@ namespace lgfx
 
     std::shared_ptr<RunTimeFont> _runtime_font;  // run-time generated font
     PointerWrapper _font_data;
+    std::uint32_t _font_cache_size = 0;
+    bool _font_cache_psram = false;
 
     bool _textwrap_x = true;
     bool _textwrap_y = false;
     bool _textscroll = false;
+    bool _jpg_pipeline = false;
+    bool _jpg_parallel = false;
+    std::uint8_t _jpg_profile = jpeg_profile::JPEG_PROFILE_DEFAULT;
+    void* _png_arena = nullptr;
+    std::size_t _png_arena_size = 0;
+    std::size_t _png_arena_peak = 0;
 
     __attribute__ ((always_inline)) inline static bool _adjust_abs(std::int32_t& x, std::int32_t& w) { if (w < 0) { x += w + 1; w = -w; } return !w; }
 
@@ -685,6 +782,7 @@ namespace lgfx
 
     void writeRawColor( std::uint32_t color, std::int32_t length) { if (0 >= length) return; setRawColor(color); pushBlock_impl(length); }
     void read_rect(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, void* dst, pixelcopy_t* param);
+    void fill_rect_alpha(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, std::uint_fast8_t alpha, std::uint32_t rgb888);
     void draw_gradient_line( std::int32_t x0, std::int32_t y0, std::int32_t x1, std::int32_t y1, uint32_t colorstart, uint32_t colorend );
     void fill_arc_helper(std::int32_t cx, std::int32_t cy, std::int32_t oradius, std::int32_t iradius, float start, float end);
     void draw_bitmap(std::int32_t x, std::int32_t y, const std::uint8_t *bitmap, std::int32_t w, std::int32_t h, std::uint32_t fg_rawcolor, std::uint32_t bg_rawcolor = ~0u);
@@ -697,6 +795,12 @@ namespace lgfx
     std::size_t printNumber(unsigned long n, std::uint8_t base);
     std::size_t printFloat(double number, std::uint8_t digits);
     std::size_t draw_string(const char *string, std::int32_t x, std::int32_t y, textdatum_t datum);
+    std::size_t draw_string_direct(const char *string, std::int32_t x, std::int32_t y, textdatum_t datum);
+    std::size_t draw_string_buffered(const char *string, std::int32_t x, std::int32_t y, textdatum_t datum);
+    std::size_t draw_char(std::int32_t x, std::int32_t y, std::uint16_t uniCode);
+    std::int32_t tabular_advance(void);
+    bool is_tabular(std::uint16_t uniCode) const { return _text_style.tabular && ((std::uint16_t)(uniCode - '0') < 10 || uniCode == ' '); }
+    void measure_layout(TextLayout* layout);
 
     bool draw_bmp(DataWrapper* data, std::int32_t x, std::int32_t y);
     bool draw_jpg(DataWrapper* data, std::int32_t x, std::int32_t y, std::int32_t maxWidth, std::int32_t maxHeight, std::int32_t offX, std::int32_t offY, jpeg_div::jpeg_div_t scale);
@@ -764,6 +868,7 @@ namespace lgfx
     using LGFXBase::_get_text_filled_x;
     using LGFXBase::_set_text_filled_x;
     using LGFXBase::_get_font_metrics;
+    using LGFXBase::_get_blend_table;
     using LGFXBase::writeRawColor;
   };
 
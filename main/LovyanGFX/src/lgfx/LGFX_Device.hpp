@@ -80,10 +80,30 @@ namespace lgfx
     void setRotation(std::int_fast8_t r)
     {
       std::uint8_t buf[32];
+      if (_vscroll_h) setVerticalScrollArea(0, 0);
       commandList(_panel->getRotationCommands(buf, r));
       postSetRotation();
     }
 
+    // パネルのハードウェア縦スクロール領域を設定する。 h = 0 で解除。
+    // 領域は画面の横幅いっぱいになる。非対応のパネル・回転方向の場合は false を返す。
+    bool setVerticalScrollArea(std::int32_t y, std::int32_t h)
+    {
+      std::uint8_t buf[16];
+      if (!commandList(_panel->getScrollAreaCommands(buf, y, h))) return false;
+      _vscroll_y = y;
+      _vscroll_h = (h > 0) ? h : 0;
+      return true;
+    }
+
+    // 領域の先頭に表示する行を指定する。 画面の y + i 行目に y + (offset + i) % h 行目の内容が表示される。
+    bool setVerticalScrollOffset(std::int32_t offset)
+    {
+      if (!_vscroll_h) return false;
+      std::uint8_t buf[8];
+      return commandList(_panel->getScrollStartCommands(buf, _vscroll_y, _vscroll_h, offset));
+    }
+
     void invertDisplay(bool i)
     {
       std::uint8_t buf[32];
@@ -247,6 +267,9 @@ namespace lgfx
 
     bool _in_transaction = false;
 
+    std::int32_t _vscroll_y = 0;
+    std::int32_t _vscroll_h = 0;
+
     virtual void preInit(void) {}
     virtual void preCommandList(void) {}
     virtual void postCommandList(void) {}
@@ -266,7 +289,7 @@ namespace lgfx
       set_touch_calibrate(parameters);
     }
 
-    void postSetColorDepth(void)
+    virtual void postSetColorDepth(void)
     {
       _write_conv.setColorDepth(_panel->write_depth);
       _read_conv.setColorDepth(_panel->read_depth);
@@ -0,0 +1,658 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX library - LCD graphics library .
+
+  support platform:
+    ESP32 (SPI/I2S) with Arduino/ESP-IDF
+    ATSAMD51 (SPI) with Arduino
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#ifndef LGFX_IMAGECACHE_HPP_
+#define LGFX_IMAGECACHE_HPP_
+
+#include <cmath>
+#include <cstring>
+
+#include "LGFX_Sprite.hpp"
+
+namespace lgfx
+{
+  // デコード済み画像のキャッシュ。JPG/PNG/BMP を描画先のピクセル形式に展開して保持し、
+  // 2回目以降はデコードせず pushImage 1回で転送する (DMA対応メモリに置いた場合はDMA転送)。
+  // キーはデータのポインタとサイズ (ファイルの場合はパス) と縮小率。内容が変わった場合は erase() で破棄すること。
+  // 容量 (budget) を超える場合は最も長く使われていない画像から破棄する。
+  // 透過を含むPNG (アルファチャンネル/tRNS) と、パレット・8bpp未満の描画先はキャッシュせず直接描画する。
+  class LGFX_ImageCache
+  {
+  public:
+
+    LGFX_ImageCache(void) {}
+
+    virtual ~LGFX_ImageCache() {
+      release();
+    }
+
+    // dst : 描画先  budget : キャッシュに使うメモリ量(byte)  max_entries : 保持する画像数の上限
+    bool begin(LovyanGFX* dst, std::size_t budget, std::size_t max_entries = 16)
+    {
+      release();
+      if (!dst || !max_entries) return false;
+      _entries = (entry_t*)heap_alloc(sizeof(entry_t) * max_entries);
+      if (!_entries) return false;
+      memset((void*)_entries, 0, sizeof(entry_t) * max_entries);
+      _dst = dst;
+      _budget = budget;
+      _max_entries = max_entries;
+      return true;
+    }
+
+    void release(void)
+    {
+      clear();
+      if (_entries) { heap_free(_entries); _entries = nullptr; }
+      _max_entries = 0;
+      _dst = nullptr;
+    }
+
+    // 全ての画像を破棄する
+    void clear(void)
+    {
+      for (std::size_t i = 0; i < _count; ++i) free_entry(&_entries[i]);
+      _count = 0;
+      _used = 0;
+    }
+
+    // 指定したデータ/ファイルの画像を (全ての縮小率について) 破棄する
+    void erase(const std::uint8_t* data)
+    {
+      for (std::size_t i = _count; i--; ) {
+        if (_entries[i].key_ptr == data && !_entries[i].path) remove_entry(i);
+      }
+    }
+
+    void erase(const char* path)
+    {
+      for (std::size_t i = _count; i--; ) {
+        if (_entries[i].path && !strcmp(_entries[i].path, path)) remove_entry(i);
+      }
+    }
+
+    // true : 画素をPSRAMに置く (DMA転送はできなくなる)
+    void setPsram(bool enabled) { _psram = enabled; }
+
+    // true : 行単位の連長圧縮で保持する (縮まない画像は無圧縮で保持する)。転送時に展開するためDMA転送はドライバのバッファ経由になる
+    void setRLE(bool enabled) { _rle = enabled; }
+
+    std::size_t getBudget(void) const { return _budget; }
+    std::size_t getUsed(void) const { return _used; }
+    std::size_t getCount(void) const { return _count; }
+    std::uint32_t getHits(void) const { return _hits; }
+    std::uint32_t getMisses(void) const { return _misses; }
+    void resetStats(void) { _hits = _misses = 0; }
+
+    bool drawJpg(const std::uint8_t *jpg_data, std::uint32_t jpg_len, std::int32_t x=0, std::int32_t y=0, jpeg_div::jpeg_div_t scale=jpeg_div::jpeg_div_t::JPEG_DIV_NONE)
+    {
+      request_t req(image_jpg, jpg_data, nullptr, jpg_len, scale, 1.0);
+      req.fp_probe = probe_memory;
+      req.fp_decode = decode_memory;
+      return draw_image(&req, x, y);
+    }
+
+    bool drawPng(const std::uint8_t *png_data, std::uint32_t png_len, std::int32_t x=0, std::int32_t y=0, double scale=1.0)
+    {
+      request_t req(image_png, png_data, nullptr, png_len, jpeg_div::jpeg_div_t::JPEG_DIV_NONE, scale);
+      req.fp_probe = probe_memory;
+      req.fp_decode = decode_memory;
+      return draw_image(&req, x, y);
+    }
+
+    bool drawBmp(const std::uint8_t *bmp_data, std::uint32_t bmp_len, std::int32_t x=0, std::int32_t y=0)
+    {
+      request_t req(image_bmp, bmp_data, nullptr, bmp_len, jpeg_div::jpeg_div_t::JPEG_DIV_NONE, 1.0);
+      req.fp_probe = probe_memory;
+      req.fp_decode = decode_memory;
+      return draw_image(&req, x, y);
+    }
+
+#if defined (LGFX_FILESYSTEM_SUPPORT_HPP_)
+ #if defined (ARDUINO)
+  #if defined (FS_H) || defined (__SEEED_FS__)
+
+    bool drawJpgFile(fs::FS &fs, const char *path, std::int32_t x=0, std::int32_t y=0, jpeg_div::jpeg_div_t scale=jpeg_div::jpeg_div_t::JPEG_DIV_NONE)
+    {
+      request_t req(image_jpg, &fs, path, 0, scale, 1.0);
+      req.fp_probe = probe_file;
+      req.fp_decode = decode_file;
+      return draw_image(&req, x, y);
+    }
+
+    bool drawPngFile(fs::FS &fs, const char *path, std::int32_t x=0, std::int32_t y=0, double scale=1.0)
+    {
+      request_t req(image_png, &fs, path, 0, jpeg_div::jpeg_div_t::JPEG_DIV_NONE, scale);
+      req.fp_probe = probe_file;
+      req.fp_decode = decode_file;
+      return draw_image(&req, x, y);
+    }
+
+    bool drawBmpFile(fs::FS &fs, const char *path, std::int32_t x=0, std::int32_t y=0)
+    {
+      request_t req(image_bmp, &fs, path, 0, jpeg_div::jpeg_div_t::JPEG_DIV_NONE, 1.0);
+      req.fp_probe = probe_file;
+      req.fp_decode = decode_file;
+      return draw_image(&req, x, y);
+    }
+
+  #endif
+ #elif defined (CONFIG_IDF_TARGET_ESP32) || defined(__SAMD51_HARMONY__) // ESP-IDF or Harmony
+
+    bool drawJpgFile(const char *path, std::int32_t x=0, std::int32_t y=0, jpeg_div::jpeg_div_t scale=jpeg_div::jpeg_div_t::JPEG_DIV_NONE)
+    {
+      request_t req(image_jpg, nullptr, path, 0, scale, 1.0);
+      req.fp_probe = probe_file;
+      req.fp_decode = decode_file;
+      return draw_image(&req, x, y);
+    }
+
+    bool drawPngFile(const char *path, std::int32_t x=0, std::int32_t y=0, double scale=1.0)
+    {
+      request_t req(image_png, nullptr, path, 0, jpeg_div::jpeg_div_t::JPEG_DIV_NONE, scale);
+      req.fp_probe = probe_file;
+      req.fp_decode = decode_file;
+      return draw_image(&req, x, y);
+    }
+
+    bool drawBmpFile(const char *path, std::int32_t x=0, std::int32_t y=0)
+    {
+      request_t req(image_bmp, nullptr, path, 0, jpeg_div::jpeg_div_t::JPEG_DIV_NONE, 1.0);
+      req.fp_probe = probe_file;
+      req.fp_decode = decode_file;
+      return draw_image(&req, x, y);
+    }
+
+ #endif
+#endif
+
+  private:
+
+    enum image_kind_t : std::uint8_t
+    { image_jpg
+    , image_png
+    , image_bmp
+    };
+
+    struct request_t
+    {
+      image_kind_t kind;
+      const void* key_ptr;     // データのポインタ (ファイルの場合は fs::FS)
+      const char* path;        // ファイルの場合のパス
+      std::uint32_t length;
+      jpeg_div::jpeg_div_t jpg_scale;
+      double png_scale;
+      std::uint32_t scale_key;
+      bool (*fp_probe)(const request_t* req, std::int32_t* w, std::int32_t* h);
+      bool (*fp_decode)(LovyanGFX* gfx, const request_t* req, std::int32_t x, std::int32_t y);
+
+      request_t(image_kind_t kind, const void* key_ptr, const char* path, std::uint32_t length, jpeg_div::jpeg_div_t jpg_scale, double png_scale)
+      : kind(kind), key_ptr(key_ptr), path(path), length(length), jpg_scale(jpg_scale), png_scale(png_scale)
+      , scale_key(kind == image_png ? (std::uint32_t)(png_scale * 65536.0) : (std::uint32_t)jpg_scale)
+      , fp_probe(nullptr), fp_decode(nullptr)
+      {}
+    };
+
+    struct entry_t
+    {
+      const void* key_ptr;
+      char* path;
+      std::uint32_t length;
+      std::uint32_t scale_key;
+      image_kind_t kind;
+      color_depth_t depth;
+      bool rle;
+      bool dma;
+      std::int32_t width;
+      std::int32_t height;
+      std::uint8_t* pixels;    // 描画先の形式の画素 (rle の場合は行オフセット表 + 圧縮データ)
+      std::size_t size;
+      std::uint32_t last_use;
+    };
+
+    // 連長圧縮データの読出し位置。pushImage から行単位・分割して呼ばれるため、続きから展開できるよう保持する
+    struct rle_cursor_t
+    {
+      const std::uint8_t* data;
+      const std::uint32_t* offsets;
+      std::int32_t width;
+      std::uint32_t bytes;
+      const std::uint8_t* ptr;
+      std::uint32_t left;      // 現在のパケットの残り画素数
+      bool run;
+      std::uint32_t next_x;
+      std::uint32_t next_y;
+    };
+
+    LovyanGFX* _dst = nullptr;
+    entry_t* _entries = nullptr;
+    std::size_t _max_entries = 0;
+    std::size_t _count = 0;
+    std::size_t _budget = 0;
+    std::size_t _used = 0;
+    std::uint32_t _tick = 0;
+    std::uint32_t _hits = 0;
+    std::uint32_t _misses = 0;
+    bool _psram = false;
+    bool _rle = false;
+
+    bool draw_image(const request_t* req, std::int32_t x, std::int32_t y)
+    {
+      if (!_dst) return false;
+      auto depth = _dst->getColorDepth();
+      for (std::size_t i = 0; i < _count; ++i) {
+        auto e = &_entries[i];
+        if (e->kind != req->kind || e->key_ptr != req->key_ptr || e->length != req->length
+         || e->scale_key != req->scale_key || e->depth != depth) continue;
+        if ((e->path == nullptr) != (req->path == nullptr)) continue;
+        if (e->path && strcmp(e->path, req->path)) continue;
+        ++_hits;
+        e->last_use = ++_tick;
+        push_entry(e, x, y);
+        return true;
+      }
+      ++_misses;
+
+      // パレットや8bpp未満の描画先は展開後の形式がパネルと一致しないため直接描画する
+      std::uint32_t bytes = _dst->getColorConverter()->bytes;
+      std::int32_t w, h;
+      if (_dst->hasPalette() || bytes == 0 || bytes > 3
+       || !req->fp_probe(req, &w, &h) || w <= 0 || h <= 0) {
+        return req->fp_decode(_dst, req, x, y);
+      }
+
+      std::size_t size = (std::size_t)w * h * bytes;
+      bool dma = false;
+      auto pixels = alloc_pixels(size, &dma);
+      if (!pixels) return req->fp_decode(_dst, req, x, y);
+      memset(pixels, 0, size);
+
+      bool res;
+      {
+        LGFX_Sprite sprite;
+        sprite.setBuffer(pixels, w, h, depth);
+        sprite.setJpgProfile(_dst->getJpgProfile());
+        res = req->fp_decode(&sprite, req, 0, 0);
+      }
+      if (!res) {
+        heap_free(pixels);
+        _used -= size;
+        return false;
+      }
+
+      bool rle = false;
+      if (_rle) {
+        std::size_t rle_size = rle_encode(nullptr, pixels, w, h, bytes);
+        // 1/8 以上縮まない場合は無圧縮のまま保持する
+        if (rle_size < size - (size >> 3)) {
+          auto buf = (std::uint8_t*)(_psram ? heap_alloc_psram(rle_size) : heap_alloc(rle_size));
+          if (buf) {
+            rle_encode(buf, pixels, w, h, bytes);
+            heap_free(pixels);
+            _used -= size - rle_size;
+            pixels = buf;
+            size = rle_size;
+            rle = true;
+          }
+        }
+      }
+
+      char* path = nullptr;
+      if (req->path) {
+        std::size_t len = strlen(req->path) + 1;
+        path = (char*)heap_alloc(len);
+        if (path) memcpy(path, req->path, len);
+      }
+      if (req->path && !path) {
+        heap_free(pixels);
+        _used -= size;
+        return req->fp_decode(_dst, req, x, y);
+      }
+
+      auto e = &_entries[_count++];
+      e->key_ptr = req->key_ptr;
+      e->path = path;
+      e->length = req->length;
+      e->scale_key = req->scale_key;
+      e->kind = req->kind;
+      e->depth = depth;
+      e->rle = rle;
+      e->dma = !rle && dma;
+      e->width = w;
+      e->height = h;
+      e->pixels = pixels;
+      e->size = size;
+      e->last_use = ++_tick;
+      push_entry(e, x, y);
+      return true;
+    }
+
+    // 容量と件数に収まるよう古い画像を破棄してから確保する。
+    // DMA対応メモリが足りない場合は通常のメモリに置き (DMA転送なし)、それも確保できない間だけ古い画像を1つずつ破棄する
+    std::uint8_t* alloc_pixels(std::size_t size, bool* dma)
+    {
+      if (size > _budget) return nullptr;
+      while (_count && (_count >= _max_entries || _used + size > _budget)) remove_lru();
+      for (;;) {
+        std::uint8_t* buf = nullptr;
+        *dma = false;
+        if (_psram) {
+          buf = (std::uint8_t*)heap_alloc_psram(size);
+        } else {
+          buf = (std::uint8_t*)heap_alloc_dma(size);
+          *dma = (buf != nullptr);
+          if (!buf) buf = (std::uint8_t*)heap_alloc(size);
+        }
+        if (buf) {
+          _used += size;
+          return buf;
+        }
+        if (!_count) return nullptr;
+        remove_lru();
+      }
+    }
+
+    void remove_lru(void)
+    {
+      std::size_t idx = 0;
+      for (std::size_t i = 1; i < _count; ++i) {
+        if ((std::int32_t)(_entries[i].last_use - _entries[idx].last_use) < 0) idx = i;
+      }
+      remove_entry(idx);
+    }
+
+    void remove_entry(std::size_t idx)
+    {
+      free_entry(&_entries[idx]);
+      _used -= _entries[idx].size;
+      if (idx != --_count) _entries[idx] = _entries[_count];
+    }
+
+    void free_entry(entry_t* e)
+    {
+      // DMA転送中の画素を解放しないよう完了を待つ
+      if (e->dma && _dst) _dst->waitDMA();
+      heap_free(e->pixels);
+      if (e->path) heap_free(e->path);
+    }
+
+    void push_entry(entry_t* e, std::int32_t x, std::int32_t y)
+    {
+      pixelcopy_t p(e->pixels, e->depth, e->depth, false);
+      if (!e->rle) {
+        _dst->pushImage(x, y, e->width, e->height, &p, e->dma);
+        return;
+      }
+      rle_cursor_t cursor;
+      cursor.offsets = (const std::uint32_t*)e->pixels;
+      cursor.data = e->pixels + e->height * sizeof(std::uint32_t);
+      cursor.width = e->width;
+      cursor.bytes = _dst->getColorConverter()->bytes;
+      cursor.next_x = cursor.next_y = ~0u;
+      p.src_data = &cursor;
+      p.no_convert = false;
+      p.fp_copy = rle_copy;
+      _dst->pushImage(x, y, e->width, e->height, &p, true);
+    }
+
+//----------------------------------------------------------------------------
+
+    // 行単位の連長圧縮。先頭に各行のオフセット表 (std::uint32_t × h) を置く
+    // 制御バイト c : 0x80未満 = 続く c+1 画素をそのまま、0x80以上 = 続く1画素を (c&0x7F)+2 回繰返す
+    // dst が nullptr の場合は必要なサイズだけを返す
+    static std::size_t rle_encode(std::uint8_t* dst, const std::uint8_t* src, std::int32_t w, std::int32_t h, std::uint32_t bytes)
+    {
+      std::size_t pos = h * sizeof(std::uint32_t);
+      for (std::int32_t y = 0; y < h; ++y) {
+        if (dst) ((std::uint32_t*)dst)[y] = pos - h * sizeof(std::uint32_t);
+        std::int32_t x = 0;
+        std::int32_t literal = 0;  // x の直前にある未出力の画素数
+        while (x < w) {
+          std::int32_t run = 1;
+          while (x + run < w && run < 129 && !memcmp(&src[x * bytes], &src[(x + run) * bytes], bytes)) ++run;
+          if (run < 3) {
+            x += run;
+            literal += run;
+            if (literal < 128 && x < w) continue;
+            run = 0;
+          }
+          while (literal) {
+            std::int32_t n = literal < 128 ? literal : 128;
+            if (dst) {
+              dst[pos] = n - 1;
+              memcpy(&dst[pos + 1], &src[(x - literal) * bytes], n * bytes);
+            }
+            pos += 1 + n * bytes;
+            literal -= n;
+          }
+          if (run) {
+            if (dst) {
+              dst[pos] = 0x80 | (run - 2);
+              memcpy(&dst[pos + 1], &src[x * bytes], bytes);
+            }
+            pos += 1 + bytes;
+            x += run;
+          }
+        }
+        src += w * bytes;
+      }
+      return pos;
+    }
+
+    static void rle_seek(rle_cursor_t* c, std::uint32_t x, std::uint32_t y)
+    {
+      y += x / c->width;
+      x %= c->width;
+      auto ptr = c->data + c->offsets[y];
+      std::uint32_t left = 0;
+      bool run = false;
+      while (x) {
+        std::uint_fast8_t ctrl = *ptr++;
+        run = ctrl & 0x80;
+        std::uint32_t n = run ? (ctrl & 0x7F) + 2 : ctrl + 1;
+        if (n > x) {
+          left = n - x;
+          if (!run) ptr += x * c->bytes;
+          break;
+        }
+        ptr += run ? c->bytes : n * c->bytes;
+        x -= n;
+      }
+      c->ptr = ptr;
+      c->left = left;
+      c->run = run;
+    }
+
+    static std::int32_t rle_copy(void* dst, std::int32_t index, std::int32_t last, pixelcopy_t* param)
+    {
+      auto c = (rle_cursor_t*)const_cast<void*>(param->src_data);
+      // 前回の続きでなければ行頭から読み直す
+      if (param->src_x != c->next_x || param->src_y != c->next_y) {
+        rle_seek(c, param->src_x, param->src_y);
+      }
+      std::uint32_t bytes = c->bytes;
+      std::uint32_t n = last - index;
+      param->src_x32 += n << FP_SCALE;
+      auto d = (std::uint8_t*)dst + index * bytes;
+      auto ptr = c->ptr;
+      std::uint32_t left = c->left;
+      bool run = c->run;
+      while (n) {
+        if (!left) {
+          std::uint_fast8_t ctrl = *ptr++;
+          run = ctrl & 0x80;
+          left = run ? (ctrl & 0x7F) + 2 : ctrl + 1;
+        }
+        std::uint32_t k = left < n ? left : n;
+        std::uint32_t len = k * bytes;
+        if (run) {
+          memcpy(d, ptr, bytes);
+          for (std::uint32_t filled = bytes; filled < len; filled <<= 1) {
+            memcpy(d + filled, d, (len - filled < filled) ? len - filled : filled);
+          }
+          if (!(left -= k)) ptr += bytes;
+        } else {
+          memcpy(d, ptr, len);
+          ptr += len;
+          left -= k;
+        }
+        d += len;
+        n -= k;
+      }
+      c->ptr = ptr;
+      c->left = left;
+      c->run = run;
+      c->next_x = param->src_x;
+      c->next_y = param->src_y;
+      return last;
+    }
+
+//----------------------------------------------------------------------------
+
+    // ヘッダから描画後のサイズを得る。透過を含むPNGは false (キャッシュしない)
+    static bool probe_header(const request_t* req, DataWrapper* data, std::int32_t* w, std::int32_t* h)
+    {
+      std::uint8_t buf[26];
+      if (req->kind == image_bmp) {
+        // draw_bmp が展開できない形式や画素データが欠けたものはキャッシュしない (黒い画像として残さないように)
+        std::uint32_t total = data->getLength();
+        bitmap_header_t bmp;
+        memset(bmp.raw, 0, sizeof(bmp.raw));
+        if (!bmp.load_bmp_header(data) || !bmp.is_supported()) return false;
+        std::uint32_t bpp = bmp.biBitCount;
+        std::uint32_t comp = bmp.biCompression;
+        *w = bmp.biWidth;
+        *h = bmp.biHeight < 0 ? -bmp.biHeight : bmp.biHeight;
+        // 無圧縮の場合はサイズの分かるデータ (メモリ上) なら画素データが揃っているか確かめる
+        std::uint64_t stride = (((std::uint64_t)*w * bpp + 31) >> 5) << 2;
+        if (total && comp != 1 && comp != 2 && bmp.bfOffBits + stride * *h > total) return false;
+        return true;
+      }
+
+      if (req->kind == image_png) {
+        if (data->read(buf, 26) != 26 || memcmp(&buf[12], "IHDR", 4)) return false;
+        std::uint32_t pw = buf[16] << 24 | buf[17] << 16 | buf[18] << 8 | buf[19];
+        std::uint32_t ph = buf[20] << 24 | buf[21] << 16 | buf[22] << 8 | buf[23];
+        if (buf[25] & 4) return false;   // アルファチャンネル付き
+        data->skip(3 + 4);               // IHDR残り + CRC
+        for (;;) {                       // IDATまでに tRNS があれば透過あり
+          if (data->read(buf, 8) != 8) return false;
+          if (!memcmp(&buf[4], "tRNS", 4)) return false;
+          if (!memcmp(&buf[4], "IDAT", 4) || !memcmp(&buf[4], "IEND", 4)) break;
+          data->skip((buf[0] << 24 | buf[1] << 16 | buf[2] << 8 | buf[3]) + 4);
+        }
+        *w = ceil(pw * req->png_scale);
+        *h = ceil(ph * req->png_scale);
+        return true;
+      }
+
+      // JPEG : SOFマーカーを探す。TJpgDecは 1/2^scale で端数を切り捨てる
+      if (data->read(buf, 2) != 2 || buf[0] != 0xFF || buf[1] != 0xD8) return false;
+      for (;;) {
+        if (data->read(buf, 4) != 4 || buf[0] != 0xFF) return false;
+        while (buf[1] == 0xFF) {
+          buf[1] = buf[2]; buf[2] = buf[3];
+          if (data->read(&buf[3], 1) != 1) return false;
+        }
+        std::uint32_t len = buf[2] << 8 | buf[3];
+        std::uint_fast8_t marker = buf[1];
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+          if (data->read(buf, 5) != 5) return false;
+          *h = (buf[1] << 8 | buf[2]) >> req->jpg_scale;
+          *w = (buf[3] << 8 | buf[4]) >> req->jpg_scale;
+          return true;
+        }
+        if (marker == 0xD9 || marker == 0xDA || len < 2) return false;
+        data->skip(len - 2);
+      }
+    }
+
+    static bool probe_memory(const request_t* req, std::int32_t* w, std::int32_t* h)
+    {
+      PointerWrapper data;
+      data.set((const std::uint8_t*)req->key_ptr, req->length);
+      return probe_header(req, &data, w, h);
+    }
+
+    static bool decode_memory(LovyanGFX* gfx, const request_t* req, std::int32_t x, std::int32_t y)
+    {
+      PointerWrapper data;
+      data.set((const std::uint8_t*)req->key_ptr, req->length);
+      switch (req->kind) {
+      // drawJpg は負の座標で右下が欠けるため offX/offY で指定する (キャッシュからの描画と結果を揃える)
+      case image_jpg: return gfx->drawJpg(&data, x < 0 ? 0 : x, y < 0 ? 0 : y, 0, 0, x < 0 ? -x : 0, y < 0 ? -y : 0, req->jpg_scale);
+      case image_png: return gfx->drawPng(&data, x, y, 0, 0, 0, 0, req->png_scale);
+      default: return gfx->drawBmp(&data, x, y);
+      }
+    }
+
+#if defined (LGFX_FILESYSTEM_SUPPORT_HPP_)
+ #if defined (ARDUINO)
+  #if defined (FS_H) || defined (__SEEED_FS__)
+
+    static bool probe_file(const request_t* req, std::int32_t* w, std::int32_t* h)
+    {
+      FileWrapper file(*(fs::FS*)req->key_ptr);
+      if (!file.open(req->path, "r")) return false;
+      bool res = probe_header(req, &file, w, h);
+      file.close();
+      return res;
+    }
+
+    static bool decode_file(LovyanGFX* gfx, const request_t* req, std::int32_t x, std::int32_t y)
+    {
+      auto& fs = *(fs::FS*)req->key_ptr;
+      switch (req->kind) {
+      case image_jpg: return gfx->drawJpgFile(fs, req->path, x < 0 ? 0 : x, y < 0 ? 0 : y, 0, 0, x < 0 ? -x : 0, y < 0 ? -y : 0, req->jpg_scale);
+      case image_png: return gfx->drawPngFile(fs, req->path, x, y, 0, 0, 0, 0, req->png_scale);
+      default: gfx->drawBmpFile(fs, req->path, x, y); return true;
+      }
+    }
+
+  #endif
+ #elif defined (CONFIG_IDF_TARGET_ESP32) || defined(__SAMD51_HARMONY__) // ESP-IDF or Harmony
+
+    static bool probe_file(const request_t* req, std::int32_t* w, std::int32_t* h)
+    {
+      FileWrapper file;
+      if (!file.open(req->path, "r")) return false;
+      bool res = probe_header(req, &file, w, h);
+      file.close();
+      return res;
+    }
+
+    static bool decode_file(LovyanGFX* gfx, const request_t* req, std::int32_t x, std::int32_t y)
+    {
+      switch (req->kind) {
+      case image_jpg: return gfx->drawJpgFile(req->path, x < 0 ? 0 : x, y < 0 ? 0 : y, 0, 0, x < 0 ? -x : 0, y < 0 ? -y : 0, req->jpg_scale);
+      case image_png: return gfx->drawPngFile(req->path, x, y, 0, 0, 0, 0, req->png_scale);
+      default: gfx->drawBmpFile(req->path, x, y); return true;
+      }
+    }
+
+ #endif
+#endif
+  };
+
+//----------------------------------------------------------------------------
+}
+
+#endif
@@ -0,0 +1,243 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX library - LCD graphics library .
+
+  support platform:
+    ESP32 (SPI/I2S) with Arduino/ESP-IDF
+    ATSAMD51 (SPI) with Arduino
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#ifndef LGFX_QRCODE_HPP_
+#define LGFX_QRCODE_HPP_
+
+#include <algorithm>
+#include <cstring>
+
+#include "LGFXBase.hpp"
+#include "utility/lgfx_qrcode.h"
+
+namespace lgfx
+{
+  // QRコードの表示用オブジェクト。エンコード結果(モジュール配列)を保持し、内容が変わった時だけ再エンコードする。
+  // 描画はモジュール1行分を1bppのラインバッファに展開し、行ごとに pushImage 1回で転送する。
+  class LGFX_QRCode
+  {
+  public:
+
+    LGFX_QRCode(void) {}
+
+    virtual ~LGFX_QRCode() {
+      release();
+    }
+
+    void release(void)
+    {
+      if (_data)    { heap_free(_data);    _data    = nullptr; }
+      if (_modules) { heap_free(_modules); _modules = nullptr; }
+      if (_line)    { heap_free(_line);    _line    = nullptr; }
+      _length = _modules_size = _line_size = 0;
+      _qrcode.size = 0;
+      _changed = false;
+    }
+
+#ifdef ARDUINO
+    bool setText(const String &string, std::uint8_t version = 1, std::uint8_t ecc = ECC_LOW) {
+      return setText(string.c_str(), version, ecc);
+    }
+#endif
+    // 内容が前回と同じ場合はエンコードしない。収まるバージョンが無い場合は false
+    bool setText(const char *string, std::uint8_t version = 1, std::uint8_t ecc = ECC_LOW)
+    {
+      return setData(reinterpret_cast<const std::uint8_t*>(string), strlen(string), version, ecc, true);
+    }
+
+    bool setBytes(const std::uint8_t *data, std::uint16_t length, std::uint8_t version = 1, std::uint8_t ecc = ECC_LOW)
+    {
+      return setData(data, length, version, ecc, false);
+    }
+
+    // 前回の draw 以降に内容が変わったか
+    bool isChanged(void) const { return _changed; }
+
+    // 1辺のモジュール数 (エンコードされていない場合は 0)
+    std::int32_t getSize(void) const { return _qrcode.size; }
+    std::uint8_t getVersion(void) const { return _qrcode.version; }
+
+    bool getModule(std::int32_t x, std::int32_t y)
+    {
+      return _qrcode.size && x >= 0 && y >= 0 && x < _qrcode.size && y < _qrcode.size
+          && lgfx_qrcode_getModule(&_qrcode, x, y);
+    }
+
+    // x,y が -1 の場合は中央、width が -1 の場合は画面の短辺の9割
+    void draw(LGFXBase* dst, std::int32_t x = -1, std::int32_t y = -1, std::int32_t width = -1)
+    {
+      if (width == -1) {
+        width = std::min(dst->width(), dst->height()) * 9 / 10;
+      }
+      if (x == -1 || y == -1) {
+        x = (dst->width() - width) >> 1;
+        y = (dst->height()- width) >> 1;
+      }
+      _changed = false;
+
+      std::int32_t size = _qrcode.size;
+      std::int32_t thickness = size ? width / size : 0;
+      dst->startWrite();
+      dst->setColor(0xFFFFFFU);
+      if (!thickness) {
+        dst->writeFillRect(x, y, width, width);
+        dst->endWrite();
+        return;
+      }
+      std::int32_t lineLength = size * thickness;
+      std::int32_t xOffset = x + ((width - lineLength) >> 1);
+      std::int32_t yOffset = y + ((width - lineLength) >> 1);
+
+      // 余白
+      dst->writeFillRect(x, y, width, yOffset - y);
+      dst->writeFillRect(x, yOffset + lineLength, width, y + width - yOffset - lineLength);
+      dst->writeFillRect(x, yOffset, xOffset - x, lineLength);
+      dst->writeFillRect(xOffset + lineLength, yOffset, x + width - xOffset - lineLength, lineLength);
+
+      std::uint32_t stride = (lineLength + 7) >> 3;
+      std::uint8_t* line = nullptr;
+      // パレットを持つ描画先は色番号の対応が取れないため、暗モジュールの連続区間ごとに塗りつぶす
+      if (!dst->hasPalette()) {
+        line = get_line(stride * thickness);
+      }
+      if (!line) {
+        dst->writeFillRect(xOffset, yOffset, lineLength, lineLength);
+        dst->setColor(0);
+        for (std::int32_t my = 0; my < size; ++my) {
+          std::int32_t mx = 0;
+          while (next_span(my, mx)) {
+            std::int32_t l = mx;
+            while (mx < size && lgfx_qrcode_getModule(&_qrcode, mx, my)) ++mx;
+            dst->writeFillRect(xOffset + l * thickness, yOffset + my * thickness, (mx - l) * thickness, thickness);
+          }
+        }
+        dst->endWrite();
+        return;
+      }
+
+      // bit 1 = 暗モジュール
+      static const bgr888_t palette[2] = { bgr888_t(255, 255, 255), bgr888_t(0, 0, 0) };
+      pixelcopy_t p(line, dst->getColorDepth(), palette_1bit, false, palette);
+      for (std::int32_t my = 0; my < size; ++my) {
+        memset(line, 0, stride);
+        std::int32_t mx = 0;
+        while (next_span(my, mx)) {
+          std::int32_t l = mx;
+          while (mx < size && lgfx_qrcode_getModule(&_qrcode, mx, my)) ++mx;
+          set_bits(line, l * thickness, mx * thickness);
+        }
+        for (std::int32_t i = 1; i < thickness; ++i) {
+          memcpy(&line[i * stride], line, stride);
+        }
+        dst->pushImage(xOffset, yOffset + my * thickness, lineLength, thickness, &p);
+      }
+      dst->endWrite();
+    }
+
+  private:
+
+    QRCode _qrcode = { 0, 0, 0, 0, 0, nullptr };
+    std::uint8_t* _data = nullptr;     // エンコード済みの内容 (比較用)
+    std::uint16_t _length = 0;
+    std::uint8_t _version = 0;         // 指定された最小バージョン
+    std::uint8_t _ecc = 0;
+    bool _text = false;
+    bool _changed = false;
+    std::uint8_t* _modules = nullptr;
+    std::size_t _modules_size = 0;
+    std::uint8_t* _line = nullptr;
+    std::size_t _line_size = 0;
+
+    bool setData(const std::uint8_t *data, std::size_t length, std::uint8_t version, std::uint8_t ecc, bool text)
+    {
+      if (length > UINT16_MAX) return false;
+      if (_data && _text == text && _version == version && _ecc == ecc
+       && _length == length && !memcmp(_data, data, length)) {
+        return _qrcode.size;
+      }
+
+      auto buf = (std::uint8_t*)heap_alloc(length + 1);
+      if (!buf) return false;
+      memcpy(buf, data, length);
+      buf[length] = 0;
+      if (_data) heap_free(_data);
+      _data = buf;
+      _length = length;
+      _version = version;
+      _ecc = ecc;
+      _text = text;
+      _changed = true;
+      _qrcode.size = 0;
+
+      for (; version <= 40; ++version) {
+        std::size_t need = lgfx_qrcode_getBufferSize(version);
+        if (_modules_size < need) {
+          auto modules = (std::uint8_t*)heap_alloc(need);
+          if (!modules) { heap_free(_data); _data = nullptr; return false; }
+          if (_modules) heap_free(_modules);
+          _modules = modules;
+          _modules_size = need;
+        }
+        auto res = text ? lgfx_qrcode_initText(&_qrcode, _modules, version, ecc, (const char*)_data)
+                        : lgfx_qrcode_initBytes(&_qrcode, _modules, version, ecc, _data, _length);
+        if (0 == res) return true;
+      }
+      _qrcode.size = 0;
+      return false;
+    }
+
+    std::uint8_t* get_line(std::size_t size)
+    {
+      if (_line_size < size) {
+        if (_line) heap_free(_line);
+        _line = (std::uint8_t*)heap_alloc(size);
+        _line_size = _line ? size : 0;
+      }
+      return _line;
+    }
+
+    // (mx, my) から右へ次の暗モジュールを探す
+    bool next_span(std::int32_t my, std::int32_t& mx)
+    {
+      while (mx < _qrcode.size && !lgfx_qrcode_getModule(&_qrcode, mx, my)) ++mx;
+      return mx < _qrcode.size;
+    }
+
+    // 1bpp (MSB first) のビット範囲 [l, r) を1にする
+    static void set_bits(std::uint8_t* buf, std::int32_t l, std::int32_t r)
+    {
+      std::int32_t lb = l >> 3, rb = r >> 3;
+      std::uint8_t lmask = 0xFF >> (l & 7);
+      std::uint8_t rmask = ~(0xFF >> (r & 7));
+      if (lb == rb) {
+        buf[lb] |= lmask & rmask;
+        return;
+      }
+      buf[lb] |= lmask;
+      if (rb - lb > 1) memset(&buf[lb + 1], 0xFF, rb - lb - 1);
+      if (rmask) buf[rb] |= rmask;
+    }
+  };
+
+//----------------------------------------------------------------------------
+}
+
+#endif
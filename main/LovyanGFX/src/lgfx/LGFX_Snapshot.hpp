@@ -0,0 +1,543 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX library - LCD graphics library .
+
+  support platform:
+    ESP32 (SPI/I2S) with Arduino/ESP-IDF
+    ATSAMD51 (SPI) with Arduino
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#ifndef LGFX_SNAPSHOT_HPP_
+#define LGFX_SNAPSHOT_HPP_
+
+#include <cstdio>
+#include <cstring>
+
+#include "LGFXBase.hpp"
+#include "utility/miniz.h"
+
+namespace lgfx
+{
+  // 描画内容をPNGとして書き出すスナップショット。
+  // 描画元から readRectRGB で1行ずつ読み出し (スプライトとRAMシャドウを持つパネルはRAMから、それ以外はパネルから読出し)、
+  // 読出しできない描画元 (isReadable() が false) の場合は何も出力せず false を返す。
+  // 圧縮は固定ハフマン符号の deflate で、一致は「3byte前 (左の画素)」と「1行前 (上の画素)」だけを探す。
+  // 画面全体のバッファや辞書は持たず、使用メモリは2行分のバッファと IDAT 1つ分の出力バッファのみ。
+  //
+  // beginRing() で確保したリングに、圧縮済みのPNGを update() で定期的に保存できる。
+  // 圧縮した出力を最新フレームと比べながら書き込み、前回から全く変わっていなければ
+  // 最新フレームの確認時刻だけを更新する (読出しは1回で、古いフレームも破棄しない)。
+  class LGFX_Snapshot
+  {
+  public:
+
+    // 出力先。false を返すと中断する
+    typedef bool (*write_func_t)(void* user, const std::uint8_t* data, std::uint32_t len);
+
+    LGFX_Snapshot(void) {}
+
+    virtual ~LGFX_Snapshot() {
+      release();
+    }
+
+    void release(void)
+    {
+      endRing();
+      if (_line) { heap_free(_line); _line = nullptr; }
+      _line_size = 0;
+    }
+
+    // 0 : 無圧縮 (stored ブロック)  1以上 : 圧縮 (既定)
+    void setLevel(std::uint_fast8_t level) { _level = level; }
+
+    // src の矩形 (w,h が 0 の場合は右端・下端まで) をPNGとして出力する
+    bool writePng(LGFXBase* src, write_func_t fp_write, void* user, std::int32_t x = 0, std::int32_t y = 0, std::int32_t w = 0, std::int32_t h = 0)
+    {
+      if (!src || !fp_write || !src->isReadable()) return false;
+      if (x < 0) { w += x; x = 0; }
+      if (y < 0) { h += y; y = 0; }
+      if (w <= 0 || w > src->width()  - x) w = src->width()  - x;
+      if (h <= 0 || h > src->height() - y) h = src->height() - y;
+      if (w < 1 || h < 1) return false;
+
+      sink_t sink = { fp_write, user, true };
+      return encode(src, x, y, w, h, &sink);
+    }
+
+//----------------------------------------------------------------------------
+
+    // 定期キャプチャ用のリングを確保する。
+    // capacity : 圧縮済みフレームの格納に使うメモリ量(byte)  interval_ms : キャプチャ間隔  max_frames : 保持するフレーム数の上限
+    // 容量を超える場合は古いフレームから破棄する
+    bool beginRing(std::size_t capacity, std::uint32_t interval_ms, std::size_t max_frames = 16)
+    {
+      endRing();
+      if (!capacity || !max_frames) return false;
+      _frames = (frame_t*)heap_alloc(sizeof(frame_t) * max_frames);
+      if (!_frames) return false;
+      _ring = (std::uint8_t*)heap_alloc_psram(capacity);
+      if (!_ring) _ring = (std::uint8_t*)heap_alloc(capacity);
+      if (!_ring) { heap_free(_frames); _frames = nullptr; return false; }
+      _ring_size = capacity;
+      _max_frames = max_frames;
+      _interval = interval_ms;
+      return true;
+    }
+
+    void endRing(void)
+    {
+      if (_ring)   { heap_free(_ring);   _ring   = nullptr; }
+      if (_frames) { heap_free(_frames); _frames = nullptr; }
+      _ring_size = _ring_used = _ring_head = 0;
+      _max_frames = _frame_first = _frame_count = 0;
+      _captured = false;
+    }
+
+    // now_ms : 現在時刻 (millis() 等)。前回のキャプチャから interval_ms 以上経過していればキャプチャする
+    bool update(LGFXBase* src, std::uint32_t now_ms)
+    {
+      if (!_ring || (_captured && now_ms - _last_ms < _interval)) return false;
+      _captured = true;
+      _last_ms = now_ms;
+      return capture(src, now_ms);
+    }
+
+    // 直ちに描画元全体をキャプチャしてリングに追加する
+    bool capture(LGFXBase* src, std::uint32_t now_ms)
+    {
+      if (!_ring || !src || !src->isReadable()) return false;
+      std::int32_t w = src->width();
+      std::int32_t h = src->height();
+      if (w < 1 || h < 1) return false;
+
+      // 出力は最新フレームと比較しながら書き進め、異なる箇所が現れた時点で一致していた分をリングに複写する。
+      // 最後まで一致した場合は最新フレームの確認時刻だけを更新する (古いフレームは破棄しない)
+      _same = (_frame_count != 0);
+      _ring_wlen = 0;
+      sink_t sink = { ring_write, this, true };
+      if (!encode(src, 0, 0, w, h, &sink)) return false;
+      if (_same) {
+        auto newest = get_frame(_frame_count - 1);
+        if (_ring_wlen == newest->size) {
+          newest->last_ms = now_ms;
+          return true;
+        }
+        if (!unshare()) return false;
+      }
+
+      if (_frame_count == _max_frames) drop_frame();
+      auto frame = &_frames[(_frame_first + _frame_count++) % _max_frames];
+      frame->offset = _ring_head;
+      frame->size = _ring_wlen;
+      frame->first_ms = frame->last_ms = now_ms;
+      _ring_head = (_ring_head + _ring_wlen) % _ring_size;
+      _ring_used += _ring_wlen;
+      return true;
+    }
+
+    // 保持しているフレームを全て破棄する
+    void clearFrames(void)
+    {
+      _frame_first = _frame_count = 0;
+      _ring_used = _ring_head = 0;
+    }
+
+    // index 0 が最も古いフレーム
+    std::size_t getFrameCount(void) const { return _frame_count; }
+    std::size_t getRingUsed(void) const { return _ring_used; }
+
+    std::uint32_t getFrameSize(std::size_t index) const { return index < _frame_count ? get_frame(index)->size : 0; }
+
+    // キャプチャした時刻
+    std::uint32_t getFrameTime(std::size_t index) const { return index < _frame_count ? get_frame(index)->first_ms : 0; }
+
+    // 同じ内容であることを最後に確認した時刻
+    std::uint32_t getFrameLastTime(std::size_t index) const { return index < _frame_count ? get_frame(index)->last_ms : 0; }
+
+    // フレームのPNGを出力する
+    bool readFrame(std::size_t index, write_func_t fp_write, void* user) const
+    {
+      if (index >= _frame_count || !fp_write) return false;
+      auto frame = get_frame(index);
+      std::size_t len = frame->size;
+      std::size_t first = _ring_size - frame->offset;
+      if (first > len) first = len;
+      return fp_write(user, &_ring[frame->offset], first)
+          && (first == len || fp_write(user, _ring, len - first));
+    }
+
+//----------------------------------------------------------------------------
+
+#if defined (ARDUINO)
+ #if defined (FS_H) || defined (__SEEED_FS__)
+
+    bool savePng(fs::FS &fs, const char *path, LGFXBase* src, std::int32_t x = 0, std::int32_t y = 0, std::int32_t w = 0, std::int32_t h = 0)
+    {
+      auto file = fs.open(path, "w");
+      if (!file) return false;
+      bool res = writePng(src, write_file, &file, x, y, w, h);
+      file.close();
+      return res;
+    }
+
+    bool saveFrame(fs::FS &fs, const char *path, std::size_t index) const
+    {
+      if (index >= _frame_count) return false;
+      auto file = fs.open(path, "w");
+      if (!file) return false;
+      bool res = readFrame(index, write_file, &file);
+      file.close();
+      return res;
+    }
+
+ #endif
+#else
+
+    bool savePng(const char *path, LGFXBase* src, std::int32_t x = 0, std::int32_t y = 0, std::int32_t w = 0, std::int32_t h = 0)
+    {
+      auto fp = fopen(path, "wb");
+      if (!fp) return false;
+      bool res = writePng(src, write_file, fp, x, y, w, h);
+      return (0 == fclose(fp)) && res;
+    }
+
+    bool saveFrame(const char *path, std::size_t index) const
+    {
+      if (index >= _frame_count) return false;
+      auto fp = fopen(path, "wb");
+      if (!fp) return false;
+      bool res = readFrame(index, write_file, fp);
+      return (0 == fclose(fp)) && res;
+    }
+
+#endif
+
+  private:
+
+    struct sink_t
+    {
+      write_func_t fp_write;
+      void* user;
+      bool ok;
+    };
+
+    struct frame_t
+    {
+      std::size_t offset;
+      std::uint32_t size;
+      std::uint32_t first_ms;
+      std::uint32_t last_ms;
+    };
+
+    static constexpr std::uint32_t idat_size = 512;  // IDAT 1つ分の出力バッファ
+
+    std::uint8_t* _line = nullptr;
+    std::size_t _line_size = 0;
+    std::uint_fast8_t _level = 1;
+
+    std::uint8_t* _ring = nullptr;
+    std::size_t _ring_size = 0;
+    std::size_t _ring_used = 0;     // 保持しているフレームの合計サイズ
+    std::size_t _ring_head = 0;     // 最新フレームの終端 (次のフレームの書込み位置)
+    std::size_t _ring_wlen = 0;     // 書込み中のフレームのサイズ
+    frame_t* _frames = nullptr;
+    std::size_t _max_frames = 0;
+    std::size_t _frame_first = 0;
+    std::size_t _frame_count = 0;
+    std::uint32_t _interval = 0;
+    std::uint32_t _last_ms = 0;
+    bool _captured = false;
+
+    bool _same = false;             // 書込み中のフレームがここまで最新フレームと同じ内容か (まだリングに書いていない)
+
+    std::uint8_t* get_line(std::size_t size)
+    {
+      if (_line_size < size) {
+        if (_line) heap_free(_line);
+        _line = (std::uint8_t*)heap_alloc(size);
+        _line_size = _line ? size : 0;
+      }
+      return _line;
+    }
+
+    const frame_t* get_frame(std::size_t index) const { return &_frames[(_frame_first + index) % _max_frames]; }
+    frame_t* get_frame(std::size_t index) { return &_frames[(_frame_first + index) % _max_frames]; }
+
+    void drop_frame(void)
+    {
+      _ring_used -= _frames[_frame_first].size;
+      _frame_first = (_frame_first + 1) % _max_frames;
+      --_frame_count;
+    }
+
+    // 最新フレームと一致していた先頭 _ring_wlen バイトを、最新フレームの後ろに複写する。
+    // 複写先は常に複写元より後ろなので、途中で最新フレーム自体を破棄しても読み終えた箇所しか上書きされない
+    bool unshare(void)
+    {
+      _same = false;
+      std::size_t src = get_frame(_frame_count - 1)->offset;
+      std::size_t len = _ring_wlen;
+      _ring_wlen = 0;
+      std::uint8_t buf[64];
+      while (len) {
+        std::uint32_t l = std::min<std::size_t>(len, sizeof(buf));
+        for (std::uint32_t i = 0; i < l; ++i) buf[i] = _ring[(src + i) % _ring_size];
+        if (!ring_write(this, buf, l)) return false;
+        src = (src + l) % _ring_size;
+        len -= l;
+      }
+      return true;
+    }
+
+    // 書込み中のフレームをリングに追記する。空きが足りなければ古いフレームを破棄する
+    static bool ring_write(void* user, const std::uint8_t* data, std::uint32_t len)
+    {
+      auto me = (LGFX_Snapshot*)user;
+      if (me->_same) {
+        auto newest = me->get_frame(me->_frame_count - 1);
+        std::uint32_t i = 0;
+        if (me->_ring_wlen + len <= newest->size) {
+          std::size_t pos = newest->offset + me->_ring_wlen;
+          while (i < len && data[i] == me->_ring[(pos + i) % me->_ring_size]) ++i;
+        }
+        if (i == len) {
+          me->_ring_wlen += len;
+          return true;
+        }
+        if (!me->unshare()) return false;
+      }
+      while (me->_ring_used + me->_ring_wlen + len > me->_ring_size) {
+        if (!me->_frame_count) return false;
+        me->drop_frame();
+      }
+      std::size_t pos = (me->_ring_head + me->_ring_wlen) % me->_ring_size;
+      std::size_t first = me->_ring_size - pos;
+      if (first > len) first = len;
+      memcpy(&me->_ring[pos], data, first);
+      memcpy(me->_ring, data + first, len - first);
+      me->_ring_wlen += len;
+      return true;
+    }
+
+    static void store_be32(std::uint8_t* dst, std::uint32_t value)
+    {
+      dst[0] = value >> 24;
+      dst[1] = value >> 16;
+      dst[2] = value >>  8;
+      dst[3] = value;
+    }
+
+    static bool put(sink_t* sink, const std::uint8_t* data, std::uint32_t len)
+    {
+      if (sink->ok && len) sink->ok = sink->fp_write(sink->user, data, len);
+      return sink->ok;
+    }
+
+    // PNGチャンクを出力する。データは最大3つに分けて渡せる
+    static bool put_chunk(sink_t* sink, const char* type
+                         , const std::uint8_t* d0, std::uint32_t l0
+                         , const std::uint8_t* d1 = nullptr, std::uint32_t l1 = 0
+                         , const std::uint8_t* d2 = nullptr, std::uint32_t l2 = 0)
+    {
+      std::uint8_t head[8];
+      store_be32(head, l0 + l1 + l2);
+      memcpy(&head[4], type, 4);
+      mz_ulong crc = mz_crc32(MZ_CRC32_INIT, &head[4], 4);
+      if (l0) crc = mz_crc32(crc, d0, l0);
+      if (l1) crc = mz_crc32(crc, d1, l1);
+      if (l2) crc = mz_crc32(crc, d2, l2);
+      std::uint8_t tail[4];
+      store_be32(tail, crc);
+      return put(sink, head, 8) && put(sink, d0, l0) && put(sink, d1, l1) && put(sink, d2, l2) && put(sink, tail, 4);
+    }
+
+#if defined (ARDUINO)
+ #if defined (FS_H) || defined (__SEEED_FS__)
+    static bool write_file(void* user, const std::uint8_t* data, std::uint32_t len)
+    {
+      return ((fs::File*)user)->write(data, len) == len;
+    }
+ #endif
+#else
+    static bool write_file(void* user, const std::uint8_t* data, std::uint32_t len)
+    {
+      return fwrite(data, 1, len, (FILE*)user) == len;
+    }
+#endif
+
+    // 固定ハフマン符号の deflate 出力。出力は idat_size ごとに IDAT チャンクにする
+    struct deflate_t
+    {
+      sink_t* sink;
+      std::uint8_t* out;
+      std::uint32_t out_len;
+      std::uint32_t bitbuf;
+      std::uint32_t bitcount;
+
+      bool flush(void)
+      {
+        bool res = !out_len || put_chunk(sink, "IDAT", out, out_len);
+        out_len = 0;
+        return res;
+      }
+
+      bool put_bits(std::uint32_t bits, std::uint32_t len)
+      {
+        bitbuf |= bits << bitcount;
+        bitcount += len;
+        while (bitcount >= 8) {
+          out[out_len++] = bitbuf;
+          bitbuf >>= 8;
+          bitcount -= 8;
+          if (out_len == idat_size && !flush()) return false;
+        }
+        return true;
+      }
+
+      // ハフマン符号は上位ビットから詰めるため反転して出力する
+      bool put_code(std::uint32_t code, std::uint32_t len)
+      {
+        code = ((code & 0x5555) << 1) | ((code >> 1) & 0x5555);
+        code = ((code & 0x3333) << 2) | ((code >> 2) & 0x3333);
+        code = ((code & 0x0F0F) << 4) | ((code >> 4) & 0x0F0F);
+        code = ((code & 0x00FF) << 8) | ((code >> 8) & 0x00FF);
+        return put_bits(code >> (16 - len), len);
+      }
+
+      bool put_symbol(std::uint32_t sym)
+      {
+        if (sym < 144) return put_code(0x030 + sym      , 8);
+        if (sym < 256) return put_code(0x190 + sym - 144, 9);
+        if (sym < 280) return put_code(        sym - 256, 7);
+        return                put_code(0x0C0 + sym - 280, 8);
+      }
+
+      // 長さ len (3~258)、距離符号 dcode の一致を出力する
+      bool put_match(std::uint32_t len, std::uint32_t dcode, std::uint32_t dbits, std::uint32_t dextra)
+      {
+        static constexpr std::uint16_t len_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        std::uint32_t i = 28;
+        while (len_base[i] > len) --i;
+        std::uint32_t lbits = (i < 8 || i == 28) ? 0 : (i - 4) >> 2;
+        return put_symbol(257 + i)
+            && (!lbits || put_bits(len - len_base[i], lbits))
+            && put_code(dcode, 5)
+            && (!dbits || put_bits(dextra, dbits));
+      }
+    };
+
+    // 距離 dist (1~32768) の符号と拡張ビット
+    static void get_distance_code(std::uint32_t dist, std::uint32_t* code, std::uint32_t* bits, std::uint32_t* extra)
+    {
+      std::uint32_t v = dist - 1;
+      if (v < 4) { *code = v; *bits = 0; *extra = 0; return; }
+      std::uint32_t nb = 31 - __builtin_clz(v);
+      *code = nb * 2 + ((v >> (nb - 1)) & 1);
+      *bits = nb - 1;
+      *extra = v & ((1 << (nb - 1)) - 1);
+    }
+
+    // 1行 (フィルタ種別の1byteを含む) を出力する。prev は1行前 (無い場合は nullptr)
+    static bool deflate_row(deflate_t* d, const std::uint8_t* cur, const std::uint8_t* prev, std::uint32_t stride, const std::uint32_t* up_code)
+    {
+      std::uint32_t p = 0;
+      do {
+        std::uint32_t max = stride - p;
+        if (max > 258) max = 258;
+        std::uint32_t up = 0;
+        std::uint32_t left = 0;
+        if (prev) { while (up < max && cur[p + up] == prev[p + up]) ++up; }
+        if (p >= 3) { while (left < max && cur[p + left] == cur[p + left - 3]) ++left; }
+        if (up >= 3 && up >= left) {
+          if (!d->put_match(up, up_code[0], up_code[1], up_code[2])) return false;
+          p += up;
+        } else if (left >= 3) {
+          if (!d->put_match(left, 2, 0, 0)) return false;  // 距離3 (左の画素)
+          p += left;
+        } else {
+          if (!d->put_symbol(cur[p])) return false;
+          ++p;
+        }
+      } while (p < stride);
+      return true;
+    }
+
+    // RGB 8bit, フィルタ無しで出力する
+    bool encode(LGFXBase* src, std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, sink_t* sink)
+    {
+      std::uint32_t stride = w * 3 + 1;
+      if (stride > 0xFFFF) return false;
+      bool stored = (_level == 0);
+      auto line = get_line(stored ? stride : stride * 2 + idat_size);
+      if (!line) return false;
+
+      static const std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+      std::uint8_t ihdr[13] = { 0 };
+      store_be32(&ihdr[0], w);
+      store_be32(&ihdr[4], h);
+      ihdr[8] = 8;  // bit depth
+      ihdr[9] = 2;  // RGB
+      if (!put(sink, signature, 8) || !put_chunk(sink, "IHDR", ihdr, 13)) return false;
+
+      mz_ulong adler = MZ_ADLER32_INIT;
+      if (stored) {
+        // 1行を1つの無圧縮ブロックとしてIDATに入れる
+        line[0] = 0;
+        for (std::int32_t i = 0; i < h; ++i) {
+          src->readRectRGB(x, y + i, w, 1, &line[1]);
+          adler = mz_adler32(adler, line, stride);
+          bool last = (i + 1 == h);
+          std::uint8_t head[7] = { 0x78, 0x01 };  // zlib header (最初の行のみ)
+          std::uint8_t* block = &head[2];
+          block[0] = last;
+          block[1] = stride;
+          block[2] = stride >> 8;
+          block[3] = ~stride;
+          block[4] = ~stride >> 8;
+          std::uint8_t tail[4];
+          store_be32(tail, adler);
+          if (!put_chunk(sink, "IDAT", i ? block : head, i ? 5 : 7, line, stride, tail, last ? 4 : 0)) return false;
+        }
+        return put_chunk(sink, "IEND", nullptr, 0);
+      }
+
+      deflate_t d = { sink, &line[stride * 2], 0, 0, 0 };
+      // 1行前との一致は距離 stride (deflate の窓 32KB を超える幅では使わない)
+      std::uint32_t up_code[3];
+      get_distance_code(stride, &up_code[0], &up_code[1], &up_code[2]);
+      std::uint8_t* cur = line;
+      std::uint8_t* prev = &line[stride];
+      if (!d.put_bits(0x0178, 16)  // zlib header
+       || !d.put_bits(3, 3)) return false;  // 最終ブロック, 固定ハフマン符号
+      for (std::int32_t i = 0; i < h; ++i) {
+        cur[0] = 0;
+        src->readRectRGB(x, y + i, w, 1, &cur[1]);
+        adler = mz_adler32(adler, cur, stride);
+        if (!deflate_row(&d, cur, (i && stride <= 32768) ? prev : nullptr, stride, up_code)) return false;
+        std::swap(cur, prev);
+      }
+      if (!d.put_symbol(256)) return false;  // end of block
+      if (d.bitcount && !d.put_bits(0, 8 - d.bitcount)) return false;
+      std::uint8_t tail[4];
+      store_be32(tail, adler);
+      for (auto v : tail) { if (!d.put_bits(v, 8)) return false; }
+      return d.flush() && put_chunk(sink, "IEND", nullptr, 0);
+    }
+  };
+
+//----------------------------------------------------------------------------
+}
+
+#endif
@@ -66,6 +66,7 @@ namespace lgfx
     {
       _palette_count = 0;
       _palette.release();
+      _palette_lut.release();
     }
 
     void deleteSprite(void)
@@ -90,6 +91,7 @@ namespace lgfx
       _index = 0;
 
       _img.release();
+      _dirty.release();
     }
 
     void setPsram( bool enabled )
@@ -111,6 +113,8 @@ namespace lgfx
       _sh = _height = h;
       _clip_b = _ye = h - 1;
       _ypivot = h >> 1;
+
+      if (_dirty_tracking) create_dirty_map();
     }
 
     void* createSprite(std::int32_t w, std::int32_t h)
@@ -142,9 +146,40 @@ namespace lgfx
 
       _clip_l = _clip_t = _index = _sx = _sy = _xs = _ys = _xptr = _yptr = 0;
 
+      if (_dirty_tracking) create_dirty_map();
+
       return _img;
     }
 
+    // 16x16pxのタイル単位で描画済み領域を記録し、pushSpriteDirtyで変更部分のみ転送できるようにする
+    bool enableDirtyTracking(bool enable = true)
+    {
+      _dirty_tracking = enable;
+      if (!enable) {
+        _dirty.release();
+        return true;
+      }
+      return !_img || create_dirty_map();
+    }
+
+    __attribute__ ((always_inline)) inline bool isDirtyTracking(void) const { return _dirty_tracking; }
+
+    void setDirty(void) { set_dirty(0, 0, _width, _height); }
+    void setDirty(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h)
+    {
+      if (x < 0) { w += x; x = 0; }
+      if (y < 0) { h += y; y = 0; }
+      if (w > _width  - x) w = _width  - x;
+      if (h > _height - y) h = _height - y;
+      if (w < 1 || h < 1) return;
+      set_dirty(x, y, w, h);
+    }
+
+    void clearDirty(void)
+    {
+      if (_dirty) memset(_dirty.get(), 0, _dirty_words * _dirty_rows * sizeof(std::uint32_t));
+    }
+
 
 #if defined (ARDUINO)
  #if defined (FS_H) || defined (__SEEED_FS__)
@@ -219,6 +254,7 @@ namespace lgfx
       for (std::uint32_t i = 0; i < _palette_count; i++) {
         _palette.img24()[i] = i * k;
       }
+      mark_dirty(0, 0, _width, _height);
     }
 
     void setBitmapColor(std::uint16_t fgcolor, std::uint16_t bgcolor)  // For 1bpp sprites
@@ -226,6 +262,7 @@ namespace lgfx
       if (_palette) {
         _palette.img24()[0] = *(rgb565_t*)&bgcolor;
         _palette.img24()[1] = *(rgb565_t*)&fgcolor;
+        mark_dirty(0, 0, _width, _height);
       }
     }
 
@@ -249,16 +286,21 @@ namespace lgfx
       if (!_palette || index >= _palette_count) return;
       rgb888_t c = convert_to_rgb888(color);
       _palette.img24()[index] = c;
+      mark_dirty(0, 0, _width, _height);
     }
 
     void setPaletteColor(size_t index, const bgr888_t& rgb)
     {
-      if (_palette && index < _palette_count) { _palette.img24()[index] = rgb; }
+      if (!_palette || index >= _palette_count) return;
+      _palette.img24()[index] = rgb;
+      mark_dirty(0, 0, _width, _height);
     }
 
     void setPaletteColor(size_t index, std::uint8_t r, std::uint8_t g, std::uint8_t b)
     {
-      if (_palette && index < _palette_count) { _palette.img24()[index].set(r, g, b); }
+      if (!_palette || index >= _palette_count) return;
+      _palette.img24()[index].set(r, g, b);
+      mark_dirty(0, 0, _width, _height);
     }
 
     __attribute__ ((always_inline)) inline void* setColorDepth(std::uint8_t bpp) { return setColorDepth((color_depth_t)bpp); }
@@ -302,6 +344,14 @@ namespace lgfx
     __attribute__ ((always_inline)) inline void pushSprite(                std::int32_t x, std::int32_t y) { push_sprite(_parent, x, y); }
     __attribute__ ((always_inline)) inline void pushSprite(LovyanGFX* dst, std::int32_t x, std::int32_t y) { push_sprite(    dst, x, y); }
 
+    // 前回から変更のあったタイルのみを矩形にまとめて転送し、記録をクリアする
+    template<typename T>
+    __attribute__ ((always_inline)) inline void pushSpriteDirty(                std::int32_t x, std::int32_t y, const T& transp) { push_sprite_dirty(_parent, x, y, _write_conv.convert(transp) & _write_conv.colormask); }
+    template<typename T>
+    __attribute__ ((always_inline)) inline void pushSpriteDirty(LovyanGFX* dst, std::int32_t x, std::int32_t y, const T& transp) { push_sprite_dirty(    dst, x, y, _write_conv.convert(transp) & _write_conv.colormask); }
+    __attribute__ ((always_inline)) inline void pushSpriteDirty(                std::int32_t x, std::int32_t y) { push_sprite_dirty(_parent, x, y); }
+    __attribute__ ((always_inline)) inline void pushSpriteDirty(LovyanGFX* dst, std::int32_t x, std::int32_t y) { push_sprite_dirty(    dst, x, y); }
+
     template<typename T> inline bool pushRotated(                float angle, const T& transp) { return push_rotate_zoom(_parent, _parent->getPivotX(), _parent->getPivotY(), angle, 1.0f, 1.0f, _write_conv.convert(transp) & _write_conv.colormask); }
     template<typename T> inline bool pushRotated(LovyanGFX* dst, float angle, const T& transp) { return push_rotate_zoom(dst    , dst    ->getPivotX(), dst    ->getPivotY(), angle, 1.0f, 1.0f, _write_conv.convert(transp) & _write_conv.colormask); }
                          inline bool pushRotated(                float angle                 ) { return push_rotate_zoom(_parent, _parent->getPivotX(), _parent->getPivotY(), angle, 1.0f, 1.0f); }
@@ -443,6 +493,7 @@ namespace lgfx
         {
           default:
           case AllocationSource::Normal:
+            source = AllocationSource::Normal;
             buffer = heap_alloc(length);
             break;
           case AllocationSource::Dma:
@@ -452,6 +503,7 @@ namespace lgfx
             buffer = heap_alloc_psram(length);
             break;
         }
+        _source = source;
         _buffer = reinterpret_cast<std::uint8_t*>(buffer);
         if ( _buffer != nullptr ) {
           _length = length;
@@ -461,7 +513,8 @@ namespace lgfx
       void release() {
         _length = 0;
         if ( _buffer != nullptr ) {
-          heap_free(_buffer);
+          // setBuffer で渡されたバッファは呼出し側の所有なので解放しない
+          if ( _source != AllocationSource::Preallocated ) heap_free(_buffer);
           _buffer = nullptr;
         }
       }
@@ -471,6 +524,7 @@ namespace lgfx
 
     SpriteBuffer _img;
     SpriteBuffer _palette;
+    SpriteBuffer _palette_lut;  // 4bpp -> swap565 expansion table for push_sprite
     //bgr888_t* _palette = nullptr;
 
     std::int32_t _bitwidth;
@@ -484,6 +538,91 @@ namespace lgfx
     bool _disable_memcpy = false; // disable PSRAM to PSRAM memcpy flg.
     bool _psram = false;
 
+    static constexpr std::int32_t DIRTY_TILE_SHIFT = 4;  // 16x16px
+    SpriteBuffer _dirty;              // dirty tile bitmap (1bit/tile)
+    std::int32_t _dirty_words = 0;    // std::uint32_t count per tile row
+    std::int32_t _dirty_cols = 0;
+    std::int32_t _dirty_rows = 0;
+    bool _dirty_tracking = false;
+
+    bool create_dirty_map(void)
+    {
+      _dirty_cols = (_width  + (1 << DIRTY_TILE_SHIFT) - 1) >> DIRTY_TILE_SHIFT;
+      _dirty_rows = (_height + (1 << DIRTY_TILE_SHIFT) - 1) >> DIRTY_TILE_SHIFT;
+      _dirty_words = (_dirty_cols + 31) >> 5;
+      _dirty.reset(_dirty_words * _dirty_rows * sizeof(std::uint32_t), AllocationSource::Normal);
+      if (!_dirty) return false;
+      memset(_dirty.get(), 0xFF, _dirty_words * _dirty_rows * sizeof(std::uint32_t));
+      return true;
+    }
+
+    __attribute__ ((always_inline)) inline void mark_dirty(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h)
+    {
+      if (_dirty) set_dirty(x, y, w, h);
+    }
+
+    void set_dirty(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h)
+    {
+      if (!_dirty) return;
+      std::int32_t tx0 =  x          >> DIRTY_TILE_SHIFT;
+      std::int32_t tx1 = (x + w - 1) >> DIRTY_TILE_SHIFT;
+      std::int32_t ty  =  y          >> DIRTY_TILE_SHIFT;
+      std::int32_t ty1 = (y + h - 1) >> DIRTY_TILE_SHIFT;
+      auto row = &reinterpret_cast<std::uint32_t*>(_dirty.get())[ty * _dirty_words];
+      do {
+        std::int32_t tx = tx0;
+        do { row[tx >> 5] |= 1u << (tx & 31); } while (++tx <= tx1);
+        row += _dirty_words;
+      } while (++ty <= ty1);
+    }
+
+    static bool test_dirty(const std::uint32_t* row, std::int32_t tx) { return row[tx >> 5] & (1u << (tx & 31)); }
+
+    void push_sprite_dirty(LovyanGFX* dst, std::int32_t x, std::int32_t y, std::uint32_t transp = ~0)
+    {
+      if (!_dirty) { push_sprite(dst, x, y, transp); return; }
+
+      std::int32_t cl, ct, cw, ch;
+      dst->getClipRect(&cl, &ct, &cw, &ch);
+      std::int32_t cr = cl + cw;
+      std::int32_t cb = ct + ch;
+
+      auto map = reinterpret_cast<std::uint32_t*>(_dirty.get());
+      dst->startWrite();
+      for (std::int32_t ty = 0; ty < _dirty_rows; ++ty) {
+        auto row = &map[ty * _dirty_words];
+        std::int32_t tx = 0;
+        while (tx < _dirty_cols) {
+          if (!test_dirty(row, tx)) { ++tx; continue; }
+
+          // 横方向に連続する変更タイルをまとめる
+          std::int32_t tx0 = tx;
+          do { row[tx >> 5] &= ~(1u << (tx & 31)); } while (++tx < _dirty_cols && test_dirty(row, tx));
+
+          // 下の行が同じ範囲すべて変更済みであれば縦方向にも結合する
+          std::int32_t ty1 = ty;
+          while (++ty1 < _dirty_rows) {
+            auto r = &map[ty1 * _dirty_words];
+            std::int32_t i = tx0;
+            while (i < tx && test_dirty(r, i)) ++i;
+            if (i != tx) break;
+            for (i = tx0; i < tx; ++i) r[i >> 5] &= ~(1u << (i & 31));
+          }
+
+          std::int32_t l = std::max(cl, x + (tx0 << DIRTY_TILE_SHIFT));
+          std::int32_t t = std::max(ct, y + (ty  << DIRTY_TILE_SHIFT));
+          std::int32_t r = std::min(cr, x + std::min(tx  << DIRTY_TILE_SHIFT, _width ));
+          std::int32_t b = std::min(cb, y + std::min(ty1 << DIRTY_TILE_SHIFT, _height));
+          if (l < r && t < b) {
+            dst->setClipRect(l, t, r - l, b - t);
+            push_sprite(dst, x, y, transp);
+          }
+        }
+      }
+      dst->setClipRect(cl, ct, cw, ch);
+      dst->endWrite();
+    }
+
     bool create_palette(void)
     {
       if (_write_conv.depth > 8) return false;
@@ -498,6 +637,7 @@ namespace lgfx
       }
       _palette_count = palettes;
       _write_conv.setColorDepth(_write_conv.depth, true);
+      mark_dirty(0, 0, _width, _height);
       return true;
     }
 
@@ -597,6 +737,15 @@ namespace lgfx
     void push_sprite(LovyanGFX* dst, std::int32_t x, std::int32_t y, std::uint32_t transp = ~0)
     {
       pixelcopy_t p(_img, dst->getColorDepth(), getColorDepth(), dst->hasPalette(), _palette, transp);
+      if (transp == ~0u && _palette && _write_conv.depth == palette_4bit && dst->getColorDepth() == rgb565_2Byte && !dst->hasPalette()) {
+        // 4bpp パレット画像はテーブル参照で2画素ずつswap565に展開する
+        if (!_palette_lut) _palette_lut.reset(256 * sizeof(std::uint32_t), AllocationSource::Normal);
+        if (_palette_lut) {
+          pixelcopy_t::make_palette4_lut(reinterpret_cast<std::uint32_t*>(_palette_lut.get()), _palette.img24());
+          p.palette = _palette_lut;
+          p.fp_copy = pixelcopy_t::palette4copy_swap565;
+        }
+      }
       dst->pushImage(x, y, _width, _height, &p, !_disable_memcpy); // DMA disable with use SPIRAM
     }
 
@@ -625,10 +774,12 @@ namespace lgfx
     void setWindow_impl(std::int32_t xs, std::int32_t ys, std::int32_t xe, std::int32_t ye) override
     {
       set_window(xs, ys, xe, ye);
+      if (_dirty && _ys < _height) set_dirty(_xs, _ys, _xe - _xs + 1, _ye - _ys + 1);
     }
 
     void drawPixel_impl(std::int32_t x, std::int32_t y) override
     {
+      mark_dirty(x, y, 1, 1);
       auto bits = _write_conv.bits;
       if (bits >= 8) {
         std::int32_t index = x + y * _bitwidth;
@@ -654,6 +805,7 @@ setWindow(x,y,x+w-1,y+h-1);
 pushBlock_impl(w*h);
 return;
 //*/
+      mark_dirty(x, y, w, h);
       std::uint32_t bits = _write_conv.bits;
       if (bits >= 8) {
         if (w == 1) {
@@ -815,6 +967,7 @@ return;
 
     void copyRect_impl(std::int32_t dst_x, std::int32_t dst_y, std::int32_t w, std::int32_t h, std::int32_t src_x, std::int32_t src_y) override
     {
+      mark_dirty(dst_x, dst_y, w, h);
       if (_write_conv.bits < 8) {
         pixelcopy_t param(_img, _write_conv.depth, _write_conv.depth);
         param.src_width = _bitwidth;
@@ -896,6 +1049,7 @@ return;
 
     void pushImage_impl(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, pixelcopy_t* param, bool) override
     {
+      mark_dirty(x, y, w, h);
       auto sx = param->src_x;
       if (param->transp == ~0u && param->no_convert && !_disable_memcpy) {
         auto bits = param->src_bits;
@@ -922,11 +1076,40 @@ return;
         }
       }
 
+      switch (_write_conv.depth) {
+      case rgb565_2Byte: push_image_rows<swap565_t>(x, y, w, h, param); break;
+      case rgb332_1Byte: push_image_rows<rgb332_t >(x, y, w, h, param); break;
+      default:           push_image_rows<bgr888_t >(x, y, w, h, param); break;
+      }
+    }
+
+    // 変換関数の組合せは呼出しごとに1回だけ判定し、組合せごとに実体化した行ループを使う
+    template <typename TDst>
+    void push_image_rows(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, pixelcopy_t* param)
+    {
+      typedef pixelcopy_t p;
+      switch (param->get_copy_kind<TDst>()) {
+      case p::copy_swap565:  push_image_rows<TDst, p::static_copier<p::normalcopy<TDst, swap565_t>, p::normalskip<swap565_t>>>(x, y, w, h, param); break;
+      case p::copy_rgb565:   push_image_rows<TDst, p::static_copier<p::normalcopy<TDst, rgb565_t >, p::normalskip<rgb565_t >>>(x, y, w, h, param); break;
+      case p::copy_bgr888:   push_image_rows<TDst, p::static_copier<p::normalcopy<TDst, bgr888_t >, p::normalskip<bgr888_t >>>(x, y, w, h, param); break;
+      case p::copy_rgb888:   push_image_rows<TDst, p::static_copier<p::normalcopy<TDst, rgb888_t >, p::normalskip<rgb888_t >>>(x, y, w, h, param); break;
+      case p::copy_rgb332:   push_image_rows<TDst, p::static_copier<p::normalcopy<TDst, rgb332_t >, p::normalskip<rgb332_t >>>(x, y, w, h, param); break;
+      case p::copy_bgr666:   push_image_rows<TDst, p::static_copier<p::normalcopy<TDst, bgr666_t >, p::normalskip<bgr666_t >>>(x, y, w, h, param); break;
+      case p::copy_palette:  push_image_rows<TDst, p::static_copier<p::palettecopy<TDst, bgr888_t>, p::bitskip>>(x, y, w, h, param); break;
+      case p::copy_palette4: push_image_rows<TDst, p::static_copier<p::palette4copy_swap565, p::bitskip>>(x, y, w, h, param); break;
+      default:               push_image_rows<TDst, p::dynamic_copier>(x, y, w, h, param); break;
+      }
+    }
+
+    template <typename TDst, typename TCopier>
+    void push_image_rows(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, pixelcopy_t* param)
+    {
+      auto sx = param->src_x;
       do {
         std::int32_t pos = x + (y++) * _bitwidth;
         std::int32_t end = pos + w;
-        while (end != (pos = param->fp_copy(_img, pos, end, param))) {
-          if ( end == (pos = param->fp_skip(      pos, end, param))) break;
+        while (end != (pos = TCopier::copy(_img, pos, end, param))) {
+          if ( end == (pos = TCopier::skip(pos, end, param))) break;
         }
         param->src_x = sx;
         param->src_y++;
@@ -981,6 +1164,10 @@ return;
 
     static void memset_multi(std::uint8_t* buf, std::uint32_t c, size_t size, size_t length)
     {
+      if (size == 2) {
+        fill_16bit(buf, c, length);
+        return;
+      }
       size_t l = length;
       if (l & ~0xF) {
         while ((l >>= 1) & ~0xF);
@@ -989,19 +1176,12 @@ return;
       size_t len = l * size;
       length = (length * size) - len;
       std::uint8_t* dst = buf;
-      if (size == 2) {
-        do { // 2byte speed tweak
-          *(std::uint16_t*)dst = c;
-          dst += 2;
-        } while (--l);
-      } else {
+      do {
+        size_t i = 0;
         do {
-          size_t i = 0;
-          do {
-            *dst++ = *(((std::uint8_t*)&c) + i);
-          } while (++i != size);
-        } while (--l);
-      }
+          *dst++ = *(((std::uint8_t*)&c) + i);
+        } while (++i != size);
+      } while (--l);
       if (!length) return;
       while (length > len) {
         memcpy(dst, buf, len);
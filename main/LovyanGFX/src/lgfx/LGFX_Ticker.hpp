@@ -0,0 +1,204 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX library - LCD graphics library .
+
+  support platform:
+    ESP32 (SPI/I2S) with Arduino/ESP-IDF
+    ATSAMD51 (SPI) with Arduino
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#ifndef LGFX_TICKER_HPP_
+#define LGFX_TICKER_HPP_
+
+#include <cstring>
+
+#include "LGFX_Sprite.hpp"
+#include "LGFX_Device.hpp"
+
+namespace lgfx
+{
+  // 1行分のメッセージ表示領域。setText() した文字列が下から上へ流れて入れ替わる。
+  // 領域が画面の横幅いっぱいで、パネルがハードウェア縦スクロール(VSCRDEF/VSCSAD)に対応していれば
+  // スクロールはパネル側で行い、新たに見える行だけを (スクロール位置を動かす前に) 転送する。
+  // それ以外の場合はスプライト上でスクロールし、新たに見える行だけを描画して領域ごと転送する。
+  // setRotation 等でスクロール領域が解除された場合は、次の update で領域を取り直す (できなければスプライトでのスクロールに切り替える)。
+  // フォント・文字色・textdatumは LGFX_Sprite と同様に設定する。(背景色は文字の背景色を使用)
+  class LGFX_Ticker : public LGFX_Sprite
+  {
+  public:
+
+    LGFX_Ticker(void)
+    : LGFX_Sprite()
+    {}
+
+    virtual ~LGFX_Ticker() {
+      release();
+    }
+
+    bool begin(LGFX_Device* dst, std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h)
+    {
+      if (!begin(static_cast<LovyanGFX*>(dst), x, y, w, h)) return false;
+      if (x == 0 && w == dst->width() && dst->setVerticalScrollArea(y, h)) {
+        _device = dst;
+      }
+      return true;
+    }
+
+    bool begin(LovyanGFX* dst, std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h)
+    {
+      release();
+      if (!createSprite(w, h)) return false;
+      _dst = dst;
+      _x = x;
+      _y = y;
+      _pos = h;
+      _offset = 0;
+      fillScreen(_text_style.back_rgb888);
+      push_sprite(_dst, _x, _y);
+      return true;
+    }
+
+    void release(void)
+    {
+      if (_device) {
+        _device->setVerticalScrollArea(0, 0);
+        _device = nullptr;
+      }
+      _dst = nullptr;
+      if (_text) { heap_free(_text); _text = nullptr; }
+      if (_prev) { heap_free(_prev); _prev = nullptr; }
+      if (_next) { heap_free(_next); _next = nullptr; }
+      deleteSprite();
+    }
+
+    // 次に表示する文字列を設定する。流し込み開始前に再度呼ばれた場合は新しい方で置き換える。
+    void setText(const char* text)
+    {
+      std::size_t len = strlen(text) + 1;
+      auto buf = static_cast<char*>(heap_alloc(len));
+      if (!buf) return;
+      memcpy(buf, text, len);
+      if (_next) heap_free(_next);
+      _next = buf;
+    }
+  #if defined (ARDUINO)
+    void setText(const String& text) { setText(text.c_str()); }
+  #endif
+
+    // step ピクセル分スクロールを進める。文字列の流し込み中は true を返す。
+    bool update(std::int32_t step = 1)
+    {
+      if (!_dst) return false;
+      if (_pos >= _height) {
+        if (!_next) return false;
+        // 上へ流れ出ていく文字列は、領域の描き直しに備えて入れ替え完了まで保持する
+        if (_prev) heap_free(_prev);
+        _prev = _text;
+        _text = _next;
+        _next = nullptr;
+        _pos = 0;
+      }
+      if (step < 1) step = 1;
+      if (step > _height - _pos) step = _height - _pos;
+
+      std::int32_t pos = _pos;
+      _pos += step;
+
+      if (_device) {
+        // 行 pos 以降の内容は、いま画面上端から出ていったメモリ行 (_offset ~ ) に書く
+        std::int32_t ring = _offset;
+        _offset = (_offset + step) % _height;
+        // 新しい行を転送し終えてからスクロール位置を動かす (古い行が下端に一瞬見えないように)
+        draw_rows(0, pos, step);
+        _device->startWrite();
+        std::int32_t len = std::min(step, _height - ring);
+        push_rows(pos, _y + ring, len);
+        if (len < step) push_rows(pos + len, _y, step - len);
+        if (_device->setVerticalScrollOffset(_offset)) {
+          _device->endWrite();
+        } else {
+          _device->endWrite();
+          restore_scroll();
+        }
+      } else {
+        setBaseColor(_text_style.back_rgb888);
+        scroll(0, -step);
+        draw_rows(_height - _pos, _height - step, step);
+        push_sprite(_dst, _x, _y);
+      }
+      return _pos < _height;
+    }
+
+    bool isScrolling(void) const { return _pos < _height || _next; }
+
+    // ハードウェアスクロールを使用しているか
+    bool hasHardwareScroll(void) const { return _device != nullptr; }
+
+  protected:
+    LovyanGFX* _dst = nullptr;
+    LGFX_Device* _device = nullptr;
+    char* _text = nullptr;
+    char* _next = nullptr;
+    char* _prev = nullptr;     // 上へ流れ出ている途中の文字列
+    std::int32_t _x = 0;
+    std::int32_t _y = 0;
+    std::int32_t _pos = 0;     // 流し込み中の文字列の、表示済みの行数
+    std::int32_t _offset = 0;  // ハードウェアスクロールの現在位置
+
+    // スクロール領域が外部から解除された場合、領域を取り直し (不可ならスプライトでのスクロールに切り替え)、
+    // 現在の表示位置で領域全体 (流れ出ている途中の文字列を含む) を描き直す
+    void restore_scroll(void)
+    {
+      auto device = _device;
+      _device = nullptr;
+      _offset = 0;
+      if (_x == 0 && _width == device->width() && device->setVerticalScrollArea(_y, _height)) {
+        if (device->setVerticalScrollOffset(0)) _device = device;
+        else device->setVerticalScrollArea(0, 0);
+      }
+      draw_rows(_height - _pos, 0, _height);
+      push_sprite(_dst, _x, _y);
+    }
+
+    // 文字列の上端を top に置き (その上には一つ前の文字列が続く)、スプライトの y から rows 行だけを描画する
+    void draw_rows(std::int32_t top, std::int32_t y, std::int32_t rows)
+    {
+      setClipRect(0, y, _width, rows);
+      setColor(_text_style.back_rgb888);
+      writeFillRect(0, y, _width, rows);
+
+      auto datum = _text_style.datum;
+      std::int32_t dx = (_width * (datum & 3)) >> 1;
+      std::int32_t dy = (datum & 4) ? (_height >> 1) : (datum & 24) ? _height : 0;
+      if (_prev && top > y) drawString(_prev, dx, top - _height + dy);
+      drawString(_text, dx, top + dy);
+      clearClipRect();
+    }
+
+    // スプライトの src_y 行から rows 行を転送先の dst_y に送る
+    void push_rows(std::int32_t src_y, std::int32_t dst_y, std::int32_t rows)
+    {
+      std::int32_t cx, cy, cw, ch;
+      _dst->getClipRect(&cx, &cy, &cw, &ch);
+      _dst->setClipRect(_x, dst_y, _width, rows);
+      push_sprite(_dst, _x, dst_y - src_y);
+      _dst->setClipRect(cx, cy, cw, ch);
+    }
+  };
+}
+
+typedef lgfx::LGFX_Ticker LGFX_Ticker;
+
+#endif
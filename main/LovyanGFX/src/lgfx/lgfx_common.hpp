@@ -26,6 +26,29 @@ Contributors:
 #include <cstring>
 #include <cstdint>
 
+// ホスト向けビルドでは、塗りつぶし・変換処理にSIMD命令 (SSE2/SSSE3, NEON) を使用する。LGFX_NO_SIMD を定義すると無効
+#if !defined (LGFX_NO_SIMD)
+ #if defined (__SSE2__)
+  #define LGFX_SIMD_SSE2
+  #include <emmintrin.h>
+  #if defined (__SSSE3__)
+   #define LGFX_SIMD_SSSE3
+   #include <tmmintrin.h>
+  #endif
+ #elif defined (__ARM_NEON) || defined (__ARM_NEON__)
+  #define LGFX_SIMD_NEON
+  #include <arm_neon.h>
+ #endif
+#endif
+
+#if !defined (ESP32) && !defined (CONFIG_IDF_TARGET_ESP32) && !defined (ESP_PLATFORM) && !defined (__SAMD51__) \
+ && (defined (__unix__) || defined (__APPLE__))
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
 namespace lgfx
 {
   namespace boards
@@ -61,6 +84,18 @@ namespace lgfx
     };
   }
 
+  namespace jpeg_profile
+  {
+    enum jpeg_profile_t
+    {
+      JPEG_PROFILE_DEFAULT    = 0,
+      JPEG_PROFILE_SWAP565    = 1,  // 描画先が16bppの場合、デコーダから RGB565 で直接出力する
+      JPEG_PROFILE_TBLCLIP    = 2,  // IDCTと色変換の飽和処理にテーブルを使用する
+      JPEG_PROFILE_LARGE_POOL = 4,  // ワークメモリを増やす (表の多いJPEGに対応し、入力バッファを拡大する)
+      JPEG_PROFILE_FAST       = JPEG_PROFILE_SWAP565 | JPEG_PROFILE_TBLCLIP,
+    };
+  }
+
   namespace colors  // Colour enumeration
   {
     #ifdef TFT_BLACK
@@ -742,6 +777,38 @@ namespace lgfx
 //----------------------------------------------------------------------------
   static constexpr std::uint32_t FP_SCALE = 16;
 
+  // 16bpp の塗りつぶし。2画素分を1word (SIMDが使える場合は8画素ずつ) で書込む
+  static inline void fill_16bit(void* buffer, std::uint32_t c, std::size_t length)
+  {
+    auto buf = (std::uint8_t*)buffer;
+#if defined (LGFX_SIMD_SSE2)
+    __m128i v = _mm_set1_epi16((short)c);
+    for (; length >= 8; length -= 8) { _mm_storeu_si128((__m128i*)buf, v); buf += 16; }
+    if (!length) return;
+#elif defined (LGFX_SIMD_NEON)
+    uint16x8_t v = vdupq_n_u16(c);
+    for (; length >= 8; length -= 8) { vst1q_u16((std::uint16_t*)buf, v); buf += 16; }
+    if (!length) return;
+#endif
+    if ((std::uintptr_t)buf & 2) {
+      *(std::uint16_t*)buf = c;
+      buf += 2;
+      if (!--length) return;
+    }
+    std::uint32_t c32 = (c & 0xFFFF) * 0x10001u;
+    auto dst32 = (std::uint32_t*)buf;
+    std::size_t l = length >> 1;
+    for (std::size_t i = l >> 2; i; --i) {
+      dst32[0] = c32;
+      dst32[1] = c32;
+      dst32[2] = c32;
+      dst32[3] = c32;
+      dst32 += 4;
+    }
+    for (l &= 3; l; --l) { *dst32++ = c32; }
+    if (length & 1) *(std::uint16_t*)dst32 = c;
+  }
+
   struct pixelcopy_t {
     union {
       std::uint32_t src_x32 = 0;
@@ -938,6 +1005,213 @@ namespace lgfx
       return index;
     }
 
+    // 連続した画素列の変換コピー (拡縮・透過なしの場合に使用)
+    template <typename TDst, typename TSrc>
+    static void copy_rgb_fast(TDst* __restrict__ d, const TSrc* __restrict__ s, std::int32_t len)
+    {
+      do { *d++ = *s++; } while (--len);
+    }
+
+    template <typename T>
+    static void copy_rgb_fast(T* __restrict__ d, const T* __restrict__ s, std::int32_t len)
+    {
+      memcpy(d, s, len * sizeof(T));
+    }
+
+    static void copy_rgb_fast(swap565_t* __restrict__ d, const swap565_t* __restrict__ s, std::int32_t len)
+    {
+      memcpy(d, s, len * sizeof(swap565_t));
+    }
+
+    // 16bpp出力は2画素を1wordにまとめて書込む
+    template <typename TSrc>
+    static void copy_rgb_fast(swap565_t* __restrict__ d, const TSrc* __restrict__ s, std::int32_t len)
+    {
+      if ((std::uintptr_t)d & 2) {
+        *d++ = *s++;
+        if (!--len) return;
+      }
+      auto d32 = (std::uint32_t*)d;
+      swap565_t c0, c1;
+      for (std::int32_t l = len >> 1; l; --l) {
+        c0 = s[0];
+        c1 = s[1];
+        s += 2;
+        *d32++ = c0.raw | c1.raw << 16;
+      }
+      if (len & 1) *(swap565_t*)d32 = *s;
+    }
+
+#if defined (LGFX_SIMD_SSSE3) || defined (LGFX_SIMD_NEON)
+    // 24bpp -> swap565 を16画素ずつ変換する。RI,BI は赤・青のバイト位置。変換した画素数を返す
+    template <int RI, int BI>
+    static std::int32_t convert_rgb24_swap565_simd(std::uint8_t* __restrict__ d, const std::uint8_t* __restrict__ s, std::int32_t len)
+    {
+      std::int32_t l = len & ~15;
+ #if defined (LGFX_SIMD_SSSE3)
+      const __m128i m0a = _mm_setr_epi8( 0, 3, 6, 9,12,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+      const __m128i m0b = _mm_setr_epi8(-1,-1,-1,-1,-1,-1, 2, 5, 8,11,14,-1,-1,-1,-1,-1);
+      const __m128i m0c = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 1, 4, 7,10,13);
+      const __m128i m1a = _mm_setr_epi8( 1, 4, 7,10,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+      const __m128i m1b = _mm_setr_epi8(-1,-1,-1,-1,-1, 0, 3, 6, 9,12,15,-1,-1,-1,-1,-1);
+      const __m128i m1c = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 2, 5, 8,11,14);
+      const __m128i m2a = _mm_setr_epi8( 2, 5, 8,11,14,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+      const __m128i m2b = _mm_setr_epi8(-1,-1,-1,-1,-1, 1, 4, 7,10,13,-1,-1,-1,-1,-1,-1);
+      const __m128i m2c = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 0, 3, 6, 9,12,15);
+      const __m128i f8 = _mm_set1_epi8((char)0xF8);
+      const __m128i e0 = _mm_set1_epi8((char)0xE0);
+      const __m128i x07 = _mm_set1_epi8(0x07);
+      const __m128i x1f = _mm_set1_epi8(0x1F);
+      for (std::int32_t i = 0; i < l; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&s[i * 3]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&s[i * 3 + 16]);
+        __m128i c = _mm_loadu_si128((const __m128i*)&s[i * 3 + 32]);
+        __m128i c0 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m0a), _mm_shuffle_epi8(b, m0b)), _mm_shuffle_epi8(c, m0c));
+        __m128i g  = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m1a), _mm_shuffle_epi8(b, m1b)), _mm_shuffle_epi8(c, m1c));
+        __m128i c2 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, m2a), _mm_shuffle_epi8(b, m2b)), _mm_shuffle_epi8(c, m2c));
+        __m128i r = RI ? c2 : c0;
+        __m128i bl = BI ? c2 : c0;
+        __m128i hi = _mm_or_si128(_mm_and_si128(r, f8), _mm_and_si128(_mm_srli_epi16(g, 5), x07));
+        __m128i lo = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(g, 3), e0), _mm_and_si128(_mm_srli_epi16(bl, 3), x1f));
+        _mm_storeu_si128((__m128i*)&d[i * 2     ], _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)&d[i * 2 + 16], _mm_unpackhi_epi8(hi, lo));
+      }
+ #else
+      for (std::int32_t i = 0; i < l; i += 16) {
+        uint8x16x3_t v = vld3q_u8(&s[i * 3]);
+        uint8x16_t r = v.val[RI];
+        uint8x16_t g = v.val[1];
+        uint8x16_t b = v.val[BI];
+        uint8x16x2_t o;
+        o.val[0] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF8)), vshrq_n_u8(g, 5));
+        o.val[1] = vorrq_u8(vandq_u8(vshlq_n_u8(g, 3), vdupq_n_u8(0xE0)), vshrq_n_u8(b, 3));
+        vst2q_u8(&d[i * 2], o);
+      }
+ #endif
+      return l;
+    }
+
+    static void copy_rgb_fast(swap565_t* __restrict__ d, const bgr888_t* __restrict__ s, std::int32_t len)
+    {
+      std::int32_t l = convert_rgb24_swap565_simd<0, 2>((std::uint8_t*)d, (const std::uint8_t*)s, len);
+      if (l != len) copy_rgb_fast<bgr888_t>(d + l, s + l, len - l);
+    }
+
+    static void copy_rgb_fast(swap565_t* __restrict__ d, const rgb888_t* __restrict__ s, std::int32_t len)
+    {
+      std::int32_t l = convert_rgb24_swap565_simd<2, 0>((std::uint8_t*)d, (const std::uint8_t*)s, len);
+      if (l != len) copy_rgb_fast<rgb888_t>(d + l, s + l, len - l);
+    }
+#endif
+
+    // rgb565 <-> swap565 は2画素分のバイトスワップを1wordで処理する
+    __attribute__ ((always_inline)) inline static std::uint32_t swap16x2(std::uint32_t v) { return ((v >> 8) & 0x00FF00FF) | ((v << 8) & 0xFF00FF00); }
+
+    static void copy_swap16(std::uint16_t* __restrict__ d, const std::uint16_t* __restrict__ s, std::int32_t len)
+    {
+#if defined (LGFX_SIMD_SSE2)
+      for (; len >= 8; len -= 8) {
+        __m128i v = _mm_loadu_si128((const __m128i*)s);
+        _mm_storeu_si128((__m128i*)d, _mm_or_si128(_mm_srli_epi16(v, 8), _mm_slli_epi16(v, 8)));
+        s += 8;
+        d += 8;
+      }
+      if (!len) return;
+#elif defined (LGFX_SIMD_NEON)
+      for (; len >= 8; len -= 8) {
+        vst1q_u8((std::uint8_t*)d, vrev16q_u8(vld1q_u8((const std::uint8_t*)s)));
+        s += 8;
+        d += 8;
+      }
+      if (!len) return;
+#endif
+      if ((std::uintptr_t)d & 2) {
+        *d++ = __builtin_bswap16(*s++);
+        if (!--len) return;
+      }
+      auto d32 = (std::uint32_t*)d;
+      std::int32_t l = len >> 1;
+      if (0 == ((std::uintptr_t)s & 2)) {
+        auto s32 = (const std::uint32_t*)s;
+        for (; l; --l) { *d32++ = swap16x2(*s32++); }
+        s = (const std::uint16_t*)s32;
+      } else {
+        for (; l; --l) { *d32++ = __builtin_bswap16(s[0]) | __builtin_bswap16(s[1]) << 16; s += 2; }
+      }
+      if (len & 1) *(std::uint16_t*)d32 = __builtin_bswap16(*s);
+    }
+
+    static void copy_rgb_fast(swap565_t* __restrict__ d, const rgb565_t* __restrict__ s, std::int32_t len)
+    {
+      copy_swap16((std::uint16_t*)d, (const std::uint16_t*)s, len);
+    }
+
+    static void copy_rgb_fast(rgb565_t* __restrict__ d, const swap565_t* __restrict__ s, std::int32_t len)
+    {
+      copy_swap16((std::uint16_t*)d, (const std::uint16_t*)s, len);
+    }
+
+    // 4bpp パレットから swap565 への変換テーブル作成。1byte(2画素)を1wordの2画素分に展開する (256 x std::uint32_t)
+    static void make_palette4_lut(std::uint32_t* lut, const bgr888_t* palette)
+    {
+      std::uint16_t c[16];
+      swap565_t tmp;
+      for (std::uint32_t i = 0; i < 16; ++i) {
+        tmp = palette[i];
+        c[i] = tmp.raw;
+      }
+      for (std::uint32_t i = 0; i < 256; ++i) {
+        lut[i] = c[i >> 4] | c[i & 15] << 16;
+      }
+    }
+
+    // paletteに make_palette4_lut で作成したテーブルを指定して使用する
+    static std::int32_t palette4copy_swap565(void* dst, std::int32_t index, std::int32_t last, pixelcopy_t* param)
+    {
+      auto s = (const std::uint8_t*)param->src_data;
+      auto d = &((std::uint16_t*)dst)[index];
+      auto lut = (const std::uint32_t*)param->palette;
+      auto src_x32     = param->src_x32;
+      auto src_y32     = param->src_y32;
+      auto src_x32_add = param->src_x32_add;
+      auto src_y32_add = param->src_y32_add;
+      auto src_width   = param->src_width;
+      std::int32_t len = last - index;
+      if (src_x32_add != (1 << FP_SCALE) || src_y32_add) {
+        do {
+          std::uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_width;
+          *d++ = lut[((s[i >> 1] >> ((~i & 1) << 2)) & 0x0F) * 0x11];
+          src_x32 += src_x32_add;
+          src_y32 += src_y32_add;
+        } while (--len);
+        param->src_x32 = src_x32;
+        param->src_y32 = src_y32;
+        return last;
+      }
+      std::uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_width;
+      param->src_x32 = src_x32 + (len << FP_SCALE);
+      s += i >> 1;
+      if (i & 1) {
+        *d++ = lut[(*s++ & 0x0F) * 0x11];
+        if (!--len) return last;
+      }
+      std::int32_t l = len >> 1;
+      if ((std::uintptr_t)d & 2) {
+        for (; l; --l) {
+          std::uint32_t c = lut[*s++];
+          d[0] = c;
+          d[1] = c >> 16;
+          d += 2;
+        }
+      } else {
+        auto d32 = (std::uint32_t*)d;
+        for (; l; --l) { *d32++ = lut[*s++]; }
+        d = (std::uint16_t*)d32;
+      }
+      if (len & 1) *d = lut[(*s >> 4) * 0x11];
+      return last;
+    }
+
     template <typename TDst, typename TSrc>
     static std::int32_t normalcopy(void* dst, std::int32_t index, std::int32_t last, pixelcopy_t* param)
     {
@@ -949,6 +1223,13 @@ namespace lgfx
       auto src_y32_add = param->src_y32_add;
       auto src_width   = param->src_width;
       auto transp      = param->transp;
+      if (src_x32_add == (1 << FP_SCALE) && !src_y32_add && transp == ~0u && TSrc::bits < 32) {
+        // 等倍・透過なしの場合は連続領域として一括変換する
+        std::uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_width;
+        copy_rgb_fast(&d[index], &s[i], last - index);
+        param->src_x32 = src_x32 + ((last - index) << FP_SCALE);
+        return last;
+      }
       do {
         std::uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_width;
         if (s[i] == transp) break;
@@ -1014,6 +1295,52 @@ namespace lgfx
       return index;
     }
 
+    // pushImage の行ループ用。変換関数を型として渡し、ループ内では直接呼び出す (インライン展開可)
+    template <std::int32_t (*Copy)(void*, std::int32_t, std::int32_t, pixelcopy_t*), std::int32_t (*Skip)(std::int32_t, std::int32_t, pixelcopy_t*)>
+    struct static_copier
+    {
+      __attribute__ ((always_inline)) inline static std::int32_t copy(void* dst, std::int32_t index, std::int32_t last, pixelcopy_t* param) { return Copy(dst, index, last, param); }
+      __attribute__ ((always_inline)) inline static std::int32_t skip(std::int32_t index, std::int32_t last, pixelcopy_t* param) { return Skip(index, last, param); }
+    };
+
+    // 既知の組合せ以外は関数ポインタ経由で呼ぶ
+    struct dynamic_copier
+    {
+      __attribute__ ((always_inline)) inline static std::int32_t copy(void* dst, std::int32_t index, std::int32_t last, pixelcopy_t* param) { return param->fp_copy(dst, index, last, param); }
+      __attribute__ ((always_inline)) inline static std::int32_t skip(std::int32_t index, std::int32_t last, pixelcopy_t* param) { return param->fp_skip(index, last, param); }
+    };
+
+    enum copy_kind_t
+    { copy_dynamic
+    , copy_swap565
+    , copy_rgb565
+    , copy_bgr888
+    , copy_rgb888
+    , copy_rgb332
+    , copy_bgr666
+    , copy_palette
+    , copy_palette4
+    };
+
+    // 転送先 TDst に対する fp_copy/fp_skip の組合せを判定する。pushImage の呼出しごとに1回だけ使用し、
+    // 結果に応じて行ループを static_copier で実体化する。透過色が無い場合は fp_skip を使わないため判定しない
+    template <typename TDst>
+    copy_kind_t get_copy_kind(void) const
+    {
+      auto fc = fp_copy;
+      auto fs = fp_skip;
+      bool t = (transp != ~0u);
+      if (fc == normalcopy<TDst, swap565_t>) return (!t || fs == normalskip<swap565_t>) ? copy_swap565 : copy_dynamic;
+      if (fc == normalcopy<TDst, rgb565_t >) return (!t || fs == normalskip<rgb565_t >) ? copy_rgb565  : copy_dynamic;
+      if (fc == normalcopy<TDst, bgr888_t >) return (!t || fs == normalskip<bgr888_t >) ? copy_bgr888  : copy_dynamic;
+      if (fc == normalcopy<TDst, rgb888_t >) return (!t || fs == normalskip<rgb888_t >) ? copy_rgb888  : copy_dynamic;
+      if (fc == normalcopy<TDst, rgb332_t >) return (!t || fs == normalskip<rgb332_t >) ? copy_rgb332  : copy_dynamic;
+      if (fc == normalcopy<TDst, bgr666_t >) return (!t || fs == normalskip<bgr666_t >) ? copy_bgr666  : copy_dynamic;
+      if (fc == palettecopy<TDst, bgr888_t>) return (!t || fs == bitskip) ? copy_palette  : copy_dynamic;
+      if (fc == palette4copy_swap565)        return (!t || fs == bitskip) ? copy_palette4 : copy_dynamic;
+      return copy_dynamic;
+    }
+
     template <typename TSrc>
     static std::int32_t normalcompare(void* dst, std::int32_t index, std::int32_t last, pixelcopy_t* param)
     {
@@ -1085,6 +1412,11 @@ namespace lgfx
     virtual bool seek(std::uint32_t offset) = 0;
     virtual void close(void) = 0;
 
+    // データがメモリ上にある場合は現在の読込み位置のポインタと残りのサイズ (並列デコード等で直接参照する)
+    // サイズが不明な場合 getLength は 0
+    virtual const std::uint8_t* getPointer(void) const { return nullptr; }
+    virtual std::uint32_t getLength(void) const { return 0; }
+
     __attribute__ ((always_inline)) inline void preRead(void) { if (fp_pre_read) fp_pre_read(parent); }
     __attribute__ ((always_inline)) inline void postRead(void) { if (fp_post_read) fp_post_read(parent); }
     __attribute__ ((always_inline)) inline bool hasParent(void) const { return parent; }
@@ -1105,6 +1437,8 @@ namespace lgfx
     void skip(std::int32_t offset) override { _index += offset; }
     bool seek(std::uint32_t offset) override { _index = offset; return true; }
     void close(void) override { }
+    const std::uint8_t* getPointer(void) const override { return &_ptr[_index]; }
+    std::uint32_t getLength(void) const override { return (_length == ~0u) ? 0 : _length - _index; }
 
   private:
     const std::uint8_t* _ptr;
@@ -1112,6 +1446,90 @@ namespace lgfx
     std::uint32_t _length = 0;
   };
 
+//----------------------------------------------------------------------------
+
+  // アセットパーティションの形式 (tools/lgfx_asset_pack.py で作成する。リトルエンディアン)
+  //  0: "LGFA"  4: 格納数  8: asset_entry_t × 格納数  以降: 各データ (4byte境界)
+  struct asset_entry_t
+  {
+    char name[24];            // NUL終端
+    std::uint32_t offset;     // パーティション先頭からの位置
+    std::uint32_t size;
+  };
+
+  // 先頭8byteを確認して格納数を得る
+  static inline bool check_asset_header(const std::uint8_t* header, std::uint32_t* count)
+  {
+    if (memcmp(header, "LGFA", 4)) return false;
+    memcpy(count, &header[4], 4);
+    return true;
+  }
+
+  static inline bool match_asset(const asset_entry_t* entry, const char* name, std::uint32_t partition_size)
+  {
+    return !strncmp(entry->name, name, sizeof(entry->name))
+        && entry->offset <= partition_size && entry->size <= partition_size - entry->offset;
+  }
+
+#if !defined (ESP32) && !defined (CONFIG_IDF_TARGET_ESP32) && !defined (ESP_PLATFORM) && !defined (__SAMD51__) \
+ && (defined (__unix__) || defined (__APPLE__))
+
+  // ホスト用 : パーティションのイメージファイルを mmap して読む (機器上の PartitionWrapper と同じ使い方ができる)
+  struct PartitionWrapper : public PointerWrapper
+  {
+    PartitionWrapper(void) = default;
+    PartitionWrapper(const PartitionWrapper&) = delete;
+    ~PartitionWrapper() { close(); }
+
+    // path : イメージファイル  name : 格納したアセット名 (nullptr の場合はファイル全体)
+    bool open(const char* path, const char* name = nullptr)
+    {
+      close();
+      int fd = ::open(path, O_RDONLY);
+      if (fd < 0) return false;
+      struct stat st;
+      void* map = MAP_FAILED;
+      if (0 == fstat(fd, &st) && st.st_size > 0) {
+        map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      }
+      ::close(fd);
+      if (map == MAP_FAILED) return false;
+      _map = map;
+      _map_len = st.st_size;
+
+      auto image = static_cast<const std::uint8_t*>(map);
+      if (!name) {
+        set(image, _map_len);
+        return true;
+      }
+      std::uint32_t count;
+      if (_map_len >= 8 && check_asset_header(image, &count) && count <= (_map_len - 8) / sizeof(asset_entry_t)) {
+        for (std::uint32_t i = 0; i < count; ++i) {
+          asset_entry_t entry;
+          memcpy(&entry, &image[8 + i * sizeof(asset_entry_t)], sizeof(entry));
+          if (match_asset(&entry, name, _map_len)) {
+            set(&image[entry.offset], entry.size);
+            return true;
+          }
+        }
+      }
+      close();
+      return false;
+    }
+
+    void close(void) override
+    {
+      if (_map) { munmap(_map, _map_len); _map = nullptr; }
+      set(nullptr, 0);
+    }
+
+  private:
+    void* _map = nullptr;
+    std::size_t _map_len = 0;
+  };
+
+#endif
+
 //----------------------------------------------------------------------------
 
   struct bitmap_header_t
@@ -1146,11 +1564,24 @@ namespace lgfx
       return ( (bfType == 0x4D42)   // bmp header "BM"
             && (biPlanes == 1)  // bcPlanes always 1
             && (biWidth > 0)
-            && (biHeight > 0)
+            && (biHeight != 0)  // 負の値は上から下へ並ぶ
             && (biBitCount <= 32)
             && (biBitCount != 0));
     }
 
+    // 展開できる色数と圧縮形式の組合せか
+    bool is_supported(void) const
+    {
+      std::uint32_t bpp = biBitCount;
+      switch (biCompression) {
+      case 0: return bpp == 1 || bpp == 2 || bpp == 4 || bpp == 8 || bpp == 16 || bpp == 24 || bpp == 32;
+      case 1: return bpp == 8;                 // RLE8
+      case 2: return bpp == 4;                 // RLE4
+      case 3: return bpp == 16 || bpp == 32;   // BITFIELDS
+      default: return false;
+      }
+    }
+
     static bool load_bmp_rle8(DataWrapper* data, std::uint8_t* linebuf, uint_fast16_t width)
     {
       width = (width + 3) & ~3;
@@ -1246,6 +1677,7 @@ namespace lgfx
     textdatum_t datum = textdatum_t::top_left;
     bool utf8 = true;
     bool cp437 = false;
+    bool tabular = false;  // 数字と空白を最大の数字幅で描画する (tabular figures)
   };
 
 //----------------------------------------------------------------------------
@@ -1275,6 +1707,7 @@ namespace lgfx
 }
 
 using namespace lgfx::jpeg_div;
+using namespace lgfx::jpeg_profile;
 using namespace lgfx::colors;
 using namespace lgfx::textdatum;
 using namespace lgfx::attribute;
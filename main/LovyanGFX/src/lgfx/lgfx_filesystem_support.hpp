@@ -65,7 +65,9 @@ namespace lgfx
         result = font->loadFont(&this->_font_file);
       }
       if (result) {
+        font->setGlyphCacheSize(this->_font_cache_size, this->_font_cache_psram);
         this->_font = font;
+        this->_tabular_font = nullptr;
         this->_font->getDefaultMetric(&this->_font_metrics);
       } else {
         this->unloadFont();
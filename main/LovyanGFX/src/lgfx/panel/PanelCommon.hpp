@@ -135,6 +135,11 @@ namespace lgfx
 
     virtual const std::uint8_t* getRotationCommands(std::uint8_t* buf, std::int_fast8_t r) = 0;
 
+    // hardware vertical scroll (VSCRDEF / VSCSAD).  y,h : scroll area in screen coordinate. h <= 0 : release.
+    // returns nullptr if the panel (or the current rotation) does not support it.
+    virtual const std::uint8_t* getScrollAreaCommands(std::uint8_t* buf, std::int_fast16_t y, std::int_fast16_t h) { ((void)buf); ((void)y); ((void)h); return nullptr; }
+    virtual const std::uint8_t* getScrollStartCommands(std::uint8_t* buf, std::int_fast16_t y, std::int_fast16_t h, std::int_fast16_t offset) { ((void)buf); ((void)y); ((void)h); ((void)offset); return nullptr; }
+
     std::uint8_t getCmdCaset(void) const { return cmd_caset; }
     std::uint8_t getCmdRaset(void) const { return cmd_raset; }
     std::uint8_t getCmdRamwr(void) const { return cmd_ramwr; }
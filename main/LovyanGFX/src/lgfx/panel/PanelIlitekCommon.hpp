@@ -43,6 +43,49 @@ namespace lgfx
       return buf;
     }
 
+    const std::uint8_t* getScrollAreaCommands(std::uint8_t* buf, std::int_fast16_t y, std::int_fast16_t h) override
+    {
+      std::int_fast16_t top = 0;
+      std::int_fast16_t bottom = 0;
+      if (h <= 0) { // 解除 : メモリ全体を一つのスクロール領域とし、開始位置を0に戻す
+        h = memory_height;
+      } else {
+        // スクロールはメモリの行方向に働くため、画面のY方向と一致する回転のみ対応する
+        if (getMadCtl(rotation) & (MAD_MV | MAD_MY)) return nullptr;
+        top = getRowStart() + y;
+        bottom = memory_height - (top + h);
+        if (top < 0 || bottom < 0) return nullptr;
+      }
+      buf[0] = CommandCommon::VSCRDEF;
+      buf[1] = 6;
+      buf[2] = top >> 8;
+      buf[3] = top;
+      buf[4] = h >> 8;
+      buf[5] = h;
+      buf[6] = bottom >> 8;
+      buf[7] = bottom;
+      buf[8] = CommandCommon::VSCSAD;
+      buf[9] = 2;
+      buf[10] = top >> 8;
+      buf[11] = top;
+      buf[12] = buf[13] = 0xFF;
+      return buf;
+    }
+
+    const std::uint8_t* getScrollStartCommands(std::uint8_t* buf, std::int_fast16_t y, std::int_fast16_t h, std::int_fast16_t offset) override
+    {
+      if (h <= 0 || (getMadCtl(rotation) & (MAD_MV | MAD_MY))) return nullptr;
+      offset %= h;
+      if (offset < 0) offset += h;
+      std::int_fast16_t line = getRowStart() + y + offset;
+      buf[0] = CommandCommon::VSCSAD;
+      buf[1] = 2;
+      buf[2] = line >> 8;
+      buf[3] = line;
+      buf[4] = buf[5] = 0xFF;
+      return buf;
+    }
+
     virtual std::uint8_t getMadCtl(std::uint8_t r) const {
       static constexpr std::uint8_t madctl_table[] = {
                                          0,
@@ -98,7 +141,9 @@ namespace lgfx
     static constexpr std::uint8_t RASET   = 0x2B; static constexpr std::uint8_t PASET = 0x2B;
     static constexpr std::uint8_t RAMWR   = 0x2C;
     static constexpr std::uint8_t RAMRD   = 0x2E;
+    static constexpr std::uint8_t VSCRDEF = 0x33;
     static constexpr std::uint8_t MADCTL  = 0x36;
+    static constexpr std::uint8_t VSCSAD  = 0x37;
     static constexpr std::uint8_t COLMOD  = 0x3A; static constexpr std::uint8_t PIXSET = 0x3A;
     };
 
@@ -82,6 +82,7 @@ namespace lgfx
         _dmadesc_len = 0;
       }
       delete_dmabuffer();
+      disableShadow();
     }
 
     LGFX_SPI() : LGFX_Device()
@@ -116,6 +117,41 @@ namespace lgfx
       spi::init(_spi_host, _spi_sclk, _spi_miso, _spi_mosi, _dma_channel);
     }
 
+    // 描画内容をRAM上(シャドウ)にも保持し、範囲内の読出しはパネルではなくRAMから行う。
+    // MISOのないパネルでも readRect / floodFill / fillRectAlpha 等が使用可能になる。
+    bool enableShadow(void) { return enableShadow(0, 0, _width, _height); }
+    bool enableShadow(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h)
+    {
+      disableShadow();
+      if (x < 0) { w += x; x = 0; }
+      if (y < 0) { h += y; y = 0; }
+      if (w > _width  - x) w = _width  - x;
+      if (h > _height - y) h = _height - y;
+      if (w < 1 || h < 1) return false;
+      std::size_t len = w * h * _write_conv.bytes;
+      _shadow = (std::uint8_t*)heap_alloc_psram(len);
+      if (!_shadow) _shadow = (std::uint8_t*)heap_alloc(len);
+      if (!_shadow) return false;
+      memset(_shadow, 0, len);
+      _shadow_x = x;
+      _shadow_y = y;
+      _shadow_w = w;
+      _shadow_h = h;
+      _shadow_bytes = _write_conv.bytes;
+      return true;
+    }
+
+    void disableShadow(void)
+    {
+      if (_shadow) {
+        heap_free(_shadow);
+        _shadow = nullptr;
+      }
+    }
+
+    __attribute__ ((always_inline)) inline bool hasShadow(void) const { return _shadow; }
+    __attribute__ ((always_inline)) inline void* getShadowBuffer(void) const { return _shadow; }
+
     void releaseBus(void)
     {
       lgfxPinMode(_spi_mosi, pin_mode_t::output);
@@ -192,8 +228,18 @@ namespace lgfx
       }
       _xs = _xe = _ys = _ye = ~0;
       _clip_l = _clip_t = 0;
+
+      if (_shadow) enableShadow(_shadow_x, _shadow_y, _shadow_w, _shadow_h);
     }
 
+    void postSetColorDepth(void) override
+    {
+      LGFX_Device::postSetColorDepth();
+      if (_shadow && _shadow_bytes != _write_conv.bytes) enableShadow(_shadow_x, _shadow_y, _shadow_w, _shadow_h);
+    }
+
+    bool isReadable_impl(void) const override { return _shadow || _panel->spi_read; }
+
     void beginTransaction_impl(void) override {
       if (_in_transaction) return;
       _in_transaction = true;
@@ -263,6 +309,7 @@ namespace lgfx
     }
 
     void writePixelsDMA_impl(const void* data, std::int32_t length) override {
+      if (_shadow) shadow_stream((const std::uint8_t*)data, length);
       write_bytes((const std::uint8_t*)data, length * _write_conv.bytes, true);
     }
 
@@ -275,10 +322,12 @@ namespace lgfx
       }
       set_window(xs, ys, xe, ye);
       write_cmd(_cmd_ramwr);
+      if (_shadow) shadow_set_window(xs, ys, xe, ye);
     }
 
     void drawPixel_impl(std::int32_t x, std::int32_t y) override
     {
+      if (_shadow) shadow_fill(x, y, 1, 1);
       if (_in_transaction) {
         if (_fill_mode) {
           _fill_mode = false;
@@ -300,6 +349,7 @@ namespace lgfx
 
     void writeFillRect_impl(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h) override
     {
+      if (_shadow) shadow_fill(x, y, w, h);
       if (_fill_mode) {
         _fill_mode = false;
         wait_spi();
@@ -312,6 +362,7 @@ namespace lgfx
 
     void pushBlock_impl(std::int32_t length) override
     {
+      if (_shadow) shadow_stream(nullptr, length);
       push_block(length);
     }
 
@@ -542,10 +593,44 @@ namespace lgfx
     }
 
     void pushImage_impl(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, pixelcopy_t* param, bool use_dma) override
+    {
+      // シャドウへは先にまとめて反映し、転送中の二重反映を避ける
+      auto shadow = _shadow;
+      if (shadow) {
+        shadow_push_image(x, y, w, h, param);
+        _shadow = nullptr;
+      }
+      switch (_write_conv.depth) {
+      case rgb565_2Byte: push_image<swap565_t>(x, y, w, h, param, use_dma); break;
+      case rgb666_3Byte: push_image<bgr666_t >(x, y, w, h, param, use_dma); break;
+      default:           push_image<bgr888_t >(x, y, w, h, param, use_dma); break;
+      }
+      _shadow = shadow;
+    }
+
+    // 変換関数の組合せは呼出しごとに1回だけ判定し、組合せごとに実体化した転送処理を使う
+    template <typename TDst>
+    void push_image(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, pixelcopy_t* param, bool use_dma)
+    {
+      typedef pixelcopy_t p;
+      switch (param->no_convert ? p::copy_dynamic : param->get_copy_kind<TDst>()) {
+      case p::copy_swap565:  push_image<TDst, p::static_copier<p::normalcopy<TDst, swap565_t>, p::normalskip<swap565_t>>>(x, y, w, h, param, use_dma); break;
+      case p::copy_rgb565:   push_image<TDst, p::static_copier<p::normalcopy<TDst, rgb565_t >, p::normalskip<rgb565_t >>>(x, y, w, h, param, use_dma); break;
+      case p::copy_bgr888:   push_image<TDst, p::static_copier<p::normalcopy<TDst, bgr888_t >, p::normalskip<bgr888_t >>>(x, y, w, h, param, use_dma); break;
+      case p::copy_rgb888:   push_image<TDst, p::static_copier<p::normalcopy<TDst, rgb888_t >, p::normalskip<rgb888_t >>>(x, y, w, h, param, use_dma); break;
+      case p::copy_rgb332:   push_image<TDst, p::static_copier<p::normalcopy<TDst, rgb332_t >, p::normalskip<rgb332_t >>>(x, y, w, h, param, use_dma); break;
+      case p::copy_bgr666:   push_image<TDst, p::static_copier<p::normalcopy<TDst, bgr666_t >, p::normalskip<bgr666_t >>>(x, y, w, h, param, use_dma); break;
+      case p::copy_palette:  push_image<TDst, p::static_copier<p::palettecopy<TDst, bgr888_t>, p::bitskip>>(x, y, w, h, param, use_dma); break;
+      case p::copy_palette4: push_image<TDst, p::static_copier<p::palette4copy_swap565, p::bitskip>>(x, y, w, h, param, use_dma); break;
+      default:               push_image<TDst, p::dynamic_copier>(x, y, w, h, param, use_dma); break;
+      }
+    }
+
+    template <typename TDst, typename TCopier>
+    void push_image(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, pixelcopy_t* param, bool use_dma)
     {
       auto bytes = _write_conv.bytes;
       auto src_x = param->src_x;
-      auto fp_copy = param->fp_copy;
 
       std::int32_t xr = (x + w) - 1;
       std::int32_t whb = w * h * bytes;
@@ -586,20 +671,20 @@ namespace lgfx
         if (_dma_channel && (64 < whb)) {
           if (param->src_width == w && (whb <= 1024)) {
             auto buf = get_dmabuffer(whb);
-            fp_copy(buf, 0, w * h, param);
+            TCopier::copy(buf, 0, w * h, param);
             setWindow_impl(x, y, xr, y + h - 1);
             write_bytes(buf, whb, true);
           } else {
             std::int32_t wb = w * bytes;
             auto buf = get_dmabuffer(wb);
-            fp_copy(buf, 0, w, param);
+            TCopier::copy(buf, 0, w, param);
             setWindow_impl(x, y, xr, y + h - 1);
             write_bytes(buf, wb, true);
             while (--h) {
               param->src_x = src_x;
               param->src_y++;
               buf = get_dmabuffer(wb);
-              fp_copy(buf, 0, w, param);
+              TCopier::copy(buf, 0, w, param);
               write_bytes(buf, wb, true);
             }
           }
@@ -612,13 +697,12 @@ namespace lgfx
           } while (--h);
         }
       } else {
-        auto fp_skip = param->fp_skip;
         h += y;
         do {
           std::int32_t i = 0;
-          while (w != (i = fp_skip(i, w, param))) {
+          while (w != (i = TCopier::skip(i, w, param))) {
             auto buf = get_dmabuffer(w * bytes);
-            std::int32_t len = fp_copy(buf, 0, w - i, param);
+            std::int32_t len = TCopier::copy(buf, 0, w - i, param);
             setWindow_impl(x + i, y, x + i + len - 1, y);
             write_bytes(buf, len * bytes, true);
             if (w == (i += len)) break;
@@ -643,6 +727,7 @@ namespace lgfx
       len = length - (len * limit);
       std::uint32_t regbuf[8];
       param->fp_copy(regbuf, 0, len, param);
+      if (_shadow) shadow_stream((const std::uint8_t*)regbuf, len);
 
       auto spi_w0_reg = _spi_w0_reg;
 
@@ -658,6 +743,7 @@ namespace lgfx
 
       for (; length; length -= limit) {
         param->fp_copy(regbuf, 0, limit, param);
+        if (_shadow) shadow_stream((const std::uint8_t*)regbuf, limit);
         memcpy((void*)&spi_w0_reg[highpart ^= 0x08], regbuf, limit * bytes);
         std::uint32_t user = user_reg;
         if (highpart) user |= SPI_USR_MOSI_HIGHPART;
@@ -729,6 +815,10 @@ namespace lgfx
 
     void readRect_impl(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, void* dst, pixelcopy_t* param) override
     {
+      if (_shadow && x >= _shadow_x && y >= _shadow_y && x + w <= _shadow_x + _shadow_w && y + h <= _shadow_y + _shadow_h) {
+        shadow_read(x, y, w, h, dst, param);
+        return;
+      }
       startWrite();
       set_window(x, y, x + w - 1, y + h - 1);
       auto len = w * h;
@@ -985,6 +1075,129 @@ namespace lgfx
     std::uint32_t _clkdiv_fill;
     std::uint32_t _len_setwindow;
     bool _fill_mode;
+
+    std::uint8_t* _shadow = nullptr;   // RAM shadow of the panel (panel write format)
+    std::int32_t _shadow_x = 0;
+    std::int32_t _shadow_y = 0;
+    std::int32_t _shadow_w = 0;
+    std::int32_t _shadow_h = 0;
+    std::int32_t _shadow_wxs = 0;      // current window for pushBlock / writePixels
+    std::int32_t _shadow_wxe = 0;
+    std::int32_t _shadow_wys = 0;
+    std::int32_t _shadow_wye = 0;
+    std::int32_t _shadow_wx = 0;
+    std::int32_t _shadow_wy = 0;
+    std::uint8_t _shadow_bytes = 0;
+
+    void shadow_set_window(std::int32_t xs, std::int32_t ys, std::int32_t xe, std::int32_t ye)
+    {
+      if (xs > xe) std::swap(xs, xe);
+      if (ys > ye) std::swap(ys, ye);
+      _shadow_wx = _shadow_wxs = xs;
+      _shadow_wy = _shadow_wys = ys;
+      _shadow_wxe = xe;
+      _shadow_wye = ye;
+    }
+
+    void shadow_write_line(std::int32_t x, std::int32_t y, std::int32_t len, const std::uint8_t* src)
+    {
+      if (y < _shadow_y || y >= _shadow_y + _shadow_h) return;
+      std::int32_t x0 = std::max(x, _shadow_x);
+      std::int32_t x1 = std::min(x + len, _shadow_x + _shadow_w);
+      if (x0 >= x1) return;
+      auto bytes = _shadow_bytes;
+      auto dst = &_shadow[((x0 - _shadow_x) + (y - _shadow_y) * _shadow_w) * bytes];
+      len = x1 - x0;
+      if (src) {
+        memcpy(dst, &src[(x0 - x) * bytes], len * bytes);
+      } else if (bytes == 2) {
+        std::uint16_t c = _color.rawL;
+        auto d = (std::uint16_t*)dst;
+        do { *d++ = c; } while (--len);
+      } else {
+        do {
+          std::int32_t i = 0;
+          do { *dst++ = _color.raw >> (i << 3); } while (++i != bytes);
+        } while (--len);
+      }
+    }
+
+    void shadow_fill(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h)
+    {
+      std::int32_t y1 = std::min(y + h, _shadow_y + _shadow_h);
+      if (y < _shadow_y) y = _shadow_y;
+      for (; y < y1; ++y) shadow_write_line(x, y, w, nullptr);
+    }
+
+    // setWindow後の連続書込みをシャドウへ反映する (src == nullptr の場合は現在の色で塗る)
+    void shadow_stream(const std::uint8_t* src, std::int32_t length)
+    {
+      auto bytes = _shadow_bytes;
+      std::int32_t len;
+      do {
+        len = std::min(length, _shadow_wxe - _shadow_wx + 1);
+        shadow_write_line(_shadow_wx, _shadow_wy, len, src);
+        if (src) src += len * bytes;
+        if ((_shadow_wx += len) > _shadow_wxe) {
+          _shadow_wx = _shadow_wxs;
+          if (++_shadow_wy > _shadow_wye) _shadow_wy = _shadow_wys;
+        }
+      } while (length -= len);
+    }
+
+    void shadow_push_image(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, const pixelcopy_t* param)
+    {
+      std::int32_t x0 = std::max(x, _shadow_x);
+      std::int32_t x1 = std::min(x + w, _shadow_x + _shadow_w);
+      std::int32_t y0 = std::max(y, _shadow_y);
+      std::int32_t y1 = std::min(y + h, _shadow_y + _shadow_h);
+      if (x0 >= x1 || y0 >= y1) return;
+
+      pixelcopy_t p = *param;
+      std::int32_t sx = p.src_x + (x0 - x);
+      p.src_y += y0 - y;
+      std::int32_t len = x1 - x0;
+      do {
+        std::int32_t pos = (x0 - _shadow_x) + (y0 - _shadow_y) * _shadow_w;
+        std::int32_t end = pos + len;
+        p.src_x = sx;
+        while (end != (pos = p.fp_copy(_shadow, pos, end, &p))) {
+          if (!p.fp_skip || end == (pos = p.fp_skip(pos, end, &p))) break;
+        }
+        p.src_y++;
+      } while (++y0 != y1);
+    }
+
+    void shadow_read(std::int32_t x, std::int32_t y, std::int32_t w, std::int32_t h, void* dst, pixelcopy_t* param)
+    {
+      // シャドウ(書込み形式)を一旦パネルの読出し形式に変換してから呼出し元の変換に渡す
+      pixelcopy_t conv(_shadow, _read_conv.depth, _write_conv.depth);
+      conv.src_width = _shadow_w;
+      // タスクのスタックを圧迫しないよう、固定長のバッファで行を分割して処理する
+      static constexpr std::int32_t chunk = 64;
+      auto rb = _read_conv.bytes;
+      std::uint8_t buf[chunk * sizeof(bgr888_t)];
+      param->src_data = buf;
+      std::int32_t dstindex = 0;
+      h += y;
+      do {
+        conv.src_y32 = (y - _shadow_y) << FP_SCALE;
+        std::int32_t cx = 0;
+        do {
+          std::int32_t len = std::min(chunk, w - cx);
+          conv.src_x32 = (x + cx - _shadow_x) << FP_SCALE;
+          conv.fp_copy(buf, 0, len, &conv);
+          if (param->no_convert) {
+            memcpy(&((std::uint8_t*)dst)[dstindex * rb], buf, len * rb);
+            dstindex += len;
+          } else {
+            param->src_x32 = 0;
+            param->src_y32 = 0;
+            dstindex = param->fp_copy(dst, dstindex, dstindex + len, param);
+          }
+        } while ((cx += chunk) < w);
+      } while (++y != h);
+    }
     bool _align_data = false;
     std::uint32_t _mask_reg_dc;
     volatile std::uint32_t* _gpio_reg_dc_h;
@@ -138,6 +138,50 @@ namespace lgfx
     return bestpre << 18 | bestn << 12 | ((bestn-1)>>1) << 6 | bestn;
   }
 
+//----------------------------------------------------------------------------
+
+  bool PartitionWrapper::open(const char* label, const char* name)
+  {
+    close();
+    auto part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (!part) return false;
+
+    std::uint32_t offset = 0;
+    std::uint32_t size = part->size;
+    if (name) {
+      // アセット表は小さいので読み出して探し、該当データの範囲だけをマップする
+      std::uint8_t header[8];
+      std::uint32_t count;
+      if (ESP_OK != esp_partition_read(part, 0, header, sizeof(header))
+       || !check_asset_header(header, &count)
+       || count > (part->size - 8) / sizeof(asset_entry_t)) return false;
+      std::uint32_t i = 0;
+      asset_entry_t entry;
+      for (; i < count; ++i) {
+        if (ESP_OK != esp_partition_read(part, 8 + i * sizeof(asset_entry_t), &entry, sizeof(entry))) return false;
+        if (match_asset(&entry, name, part->size)) break;
+      }
+      if (i == count || !entry.size) return false;
+      offset = entry.offset;
+      size = entry.size;
+    }
+
+    const void* ptr;
+    if (ESP_OK != esp_partition_mmap(part, offset, size, SPI_FLASH_MMAP_DATA, &ptr, &_handle)) return false;
+    _mapped = true;
+    set(static_cast<const std::uint8_t*>(ptr), size);
+    return true;
+  }
+
+  void PartitionWrapper::close(void)
+  {
+    if (_mapped) {
+      spi_flash_munmap(_handle);
+      _mapped = false;
+    }
+    set(nullptr, 0);
+  }
+
 //----------------------------------------------------------------------------
 
   FileWrapper::FileWrapper()
@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <driver/i2c.h>
+#include <esp_partition.h>
 
 #if defined ARDUINO
   #include <Arduino.h>
@@ -98,6 +99,25 @@ namespace lgfx
 
 #endif
 
+//----------------------------------------------------------------------------
+
+  // パーティションをメモリ空間にマップして読む (esp_partition_mmap)。
+  // getPointer() でマップ先を直接参照できるため、デコーダやフォントはVFSを通さずコピーなしで読める。
+  struct PartitionWrapper : public PointerWrapper
+  {
+    PartitionWrapper(void) = default;
+    PartitionWrapper(const PartitionWrapper&) = delete;
+    ~PartitionWrapper() { close(); }
+
+    // label : パーティション名  name : tools/lgfx_asset_pack.py で格納したアセット名 (nullptr の場合はパーティション全体)
+    bool open(const char* label, const char* name = nullptr);
+    void close(void) override;
+
+  private:
+    spi_flash_mmap_handle_t _handle = 0;
+    bool _mapped = false;
+  };
+
 //----------------------------------------------------------------------------
 
 #if defined (ARDUINO) && defined (Stream_h)
@@ -0,0 +1,364 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX library - LCD graphics library .
+
+  support platform:
+    ESP32 (SPI/I2S) with Arduino/ESP-IDF
+    ATSAMD51 (SPI) with Arduino
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#ifndef LGFX_JPG_PARALLEL_HPP_
+#define LGFX_JPG_PARALLEL_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "lgfx_tjpgd.h"
+
+#if defined (ESP32) || defined (CONFIG_IDF_TARGET_ESP32) || defined (ESP_PLATFORM)
+  #include <freertos/FreeRTOS.h>
+  #include <freertos/task.h>
+  #include <freertos/semphr.h>
+  #define LGFX_JPG_PARALLEL_FREERTOS
+#elif !defined (__SAMD51__)
+  #include <thread>
+  #include <mutex>
+  #include <condition_variable>
+  #define LGFX_JPG_PARALLEL_STD_THREAD
+#endif
+
+namespace lgfx
+{
+  // 再開マーカー(DRI)を持つメモリ上のJPEGを、再開区間の境界で区切ったMCU行のグループに分け、
+  // 2つのワーカー(ESP32では各コアに固定したタスク、それ以外では std::thread)で交互にデコードする。
+  // 各ワーカーはグループをバンド(出力形式の矩形バッファ)へ変換し、
+  // 呼出し元は揃ったバンドを走査線順に output で受け取る。
+  // (上下半分ずつではなく交互に分担するのは、先行する半分の完了を待つ間のバッファを持たずに済ませるため)
+  class jpg_parallel_t
+  {
+  public:
+    static constexpr int worker_count = 2;
+
+    // MCU(rect)をバンド内の dst (MCU左上の位置、1行 stride 画素) へ変換する。ワーカーのタスクで呼ばれる
+    typedef void (*convert_t)(void* param, int worker, void* bitmap, const JRECT* rect, std::uint8_t* dst, std::int32_t stride);
+
+    // バンドを出力する。呼出し元のタスクで走査線順に呼ばれる。false で中断
+    // band は次の output 呼出しから戻った後に再利用される (DMA転送は次の転送開始前に完了している必要がある)
+    typedef bool (*output_t)(void* param, std::uint8_t* band, std::int32_t y, std::int32_t w, std::int32_t h);
+
+    jpg_parallel_t(void) = default;
+    jpg_parallel_t(const jpg_parallel_t&) = delete;
+    jpg_parallel_t& operator=(const jpg_parallel_t&) = delete;
+    ~jpg_parallel_t() { release(); }
+
+    // jd : lgfx_jd_prepare 済みのデコーダ (表はワーカーと共有する)
+    // data, len : JPEGデータ全体、bytes : 出力1画素のバイト数
+    // DRIがない・グループが1つしかない・メモリ不足の場合は false
+    bool setup(const lgfxJdec* jd, const std::uint8_t* data, std::uint32_t len, std::uint_fast8_t scale, std::uint_fast8_t bytes)
+    {
+      release();
+#if defined (LGFX_JPG_PARALLEL_FREERTOS) || defined (LGFX_JPG_PARALLEL_STD_THREAD)
+      if (!jd->nrst || !data || scale > 3) return false;
+
+      std::uint32_t mx = jd->msx << 3;
+      std::uint32_t my = jd->msy << 3;
+      std::uint32_t mcus_x = (jd->width + mx - 1) / mx;
+      std::uint32_t mcu_rows = (jd->height + my - 1) / my;
+
+      // 再開区間とMCU行の境界が一致する最小の行数をグループとする
+      std::uint32_t a = jd->nrst, b = mcus_x;
+      while (b) { std::uint32_t t = a % b; a = b; b = t; }
+      _group_rows = jd->nrst / a;
+      _groups = (mcu_rows + _group_rows - 1) / _group_rows;
+      if (_groups < 2) return false;
+
+      _src = jd;
+      _data = data;
+      _len = len;
+      _scale = scale;
+      _bytes = bytes;
+      _band_width = jd->width >> scale;
+      _band_len = _band_width * ((_group_rows * my) >> scale) * bytes;
+      if (!_band_len) return false;
+
+      _offsets = static_cast<std::uint32_t*>(heap_alloc(_groups * sizeof(std::uint32_t)));
+      if (!_offsets || !scan_offsets(mcus_x)) { release(); return false; }
+
+      std::size_t n = jd->msx * jd->msy;
+      std::size_t work = n * 64 * 2 + 64;
+      if (work < 256) work = 256;
+      std::size_t sz_pool = JD_SZBUF + ((work + 3) & ~3) + (n + 2) * 64;
+
+      for (int i = 0; i < worker_count; ++i) {
+        auto w = &_worker[i];
+        w->owner = this;
+        w->index = i;
+        w->pool = static_cast<std::uint8_t*>(heap_alloc_dma(sz_pool));
+        w->band[0] = static_cast<std::uint8_t*>(heap_alloc_dma(_band_len));
+        w->band[1] = static_cast<std::uint8_t*>(heap_alloc_dma(_band_len));
+        if (!w->pool || !w->band[0] || !w->band[1]
+         || JDR_OK != lgfx_jd_share(&w->jd, jd, read_data, w->pool, sz_pool, w)
+         || !w->sem_free.init(2) || !w->sem_ready.init(0)) {
+          release();
+          return false;
+        }
+      }
+      return true;
+#else
+      (void)jd; (void)data; (void)len; (void)scale; (void)bytes;
+      return false;
+#endif
+    }
+
+    // setup 後にデコードする。タスクの生成に失敗した場合は何も出力せず JDR_MEM1
+    JRESULT decode(convert_t convert, output_t output, void* param)
+    {
+#if defined (LGFX_JPG_PARALLEL_FREERTOS) || defined (LGFX_JPG_PARALLEL_STD_THREAD)
+      if (!_offsets) return JDR_PAR;
+      _convert = convert;
+      _param = param;
+      _abort = false;
+
+      int started = 0;
+      for (; started < worker_count; ++started) {
+        if (!start_worker(&_worker[started])) break;
+      }
+
+      JRESULT res = started == worker_count ? JDR_OK : JDR_MEM1;
+      if (res != JDR_OK) _abort = true;
+
+      // 揃ったバンドを走査線順に出力し、ひとつ前のバンドをワーカーへ返す
+      std::uint32_t my = _src->msy << 3;
+      worker_t* prev = nullptr;
+      for (std::uint32_t g = 0; g < _groups; ++g) {
+        auto w = &_worker[g % worker_count];
+        if (w->index >= started) continue;
+        w->sem_ready.take();
+        std::int32_t h = w->band_h[(g / worker_count) & 1];
+        if (!_abort && h > 0) {
+          std::int32_t y = (g * _group_rows * my) >> _scale;
+          if (!output(param, w->band[(g / worker_count) & 1], y, _band_width, h)) {
+            _abort = true;
+            res = JDR_INTR;
+          }
+        }
+        if (prev) prev->sem_free.give();
+        prev = w;
+      }
+      if (prev) prev->sem_free.give();
+
+      for (int i = 0; i < started; ++i) {
+        join_worker(&_worker[i]);
+        if (res == JDR_OK) res = _worker[i].result;
+      }
+      return res;
+#else
+      (void)convert; (void)output; (void)param;
+      return JDR_PAR;
+#endif
+    }
+
+    void release(void)
+    {
+      for (int i = 0; i < worker_count; ++i) {
+        auto w = &_worker[i];
+        if (w->pool)    { heap_free(w->pool);    w->pool = nullptr; }
+        if (w->band[0]) { heap_free(w->band[0]); w->band[0] = nullptr; }
+        if (w->band[1]) { heap_free(w->band[1]); w->band[1] = nullptr; }
+        w->sem_free.release();
+        w->sem_ready.release();
+      }
+      if (_offsets) { heap_free(_offsets); _offsets = nullptr; }
+    }
+
+  private:
+
+#if defined (LGFX_JPG_PARALLEL_FREERTOS)
+    struct semaphore_t
+    {
+      SemaphoreHandle_t handle = nullptr;
+      bool init(std::uint32_t count) { handle = xSemaphoreCreateCounting(2, count); return handle != nullptr; }
+      void take(void) { xSemaphoreTake(handle, portMAX_DELAY); }
+      void give(void) { xSemaphoreGive(handle); }
+      void release(void) { if (handle) { vSemaphoreDelete(handle); handle = nullptr; } }
+    };
+#else
+    struct semaphore_t
+    {
+  #if defined (LGFX_JPG_PARALLEL_STD_THREAD)
+      std::mutex mtx;
+      std::condition_variable cv;
+      std::uint32_t count = 0;
+      bool init(std::uint32_t c) { count = c; return true; }
+      void take(void) { std::unique_lock<std::mutex> lock(mtx); cv.wait(lock, [this]{ return count > 0; }); --count; }
+      void give(void) { { std::lock_guard<std::mutex> lock(mtx); ++count; } cv.notify_one(); }
+  #else
+      bool init(std::uint32_t) { return false; }
+      void take(void) {}
+      void give(void) {}
+  #endif
+      void release(void) {}
+    };
+#endif
+
+    struct worker_t
+    {
+      jpg_parallel_t* owner = nullptr;
+      int index = 0;
+      lgfxJdec jd;
+      std::uint8_t* pool = nullptr;
+      std::uint8_t* band[2] = { nullptr, nullptr };
+      std::int32_t band_h[2] = { 0, 0 };
+      std::uint8_t* dst = nullptr;    // デコード中のバンド
+      std::int32_t dst_y = 0;         // デコード中のバンド上端の出力座標
+      std::int32_t dst_bottom = 0;
+      std::uint32_t pos = 0;          // 入力位置
+      JRESULT result = JDR_OK;
+      semaphore_t sem_free;           // 空いたバンドの数
+      semaphore_t sem_ready;          // 出力待ちのバンドの数
+#if defined (LGFX_JPG_PARALLEL_FREERTOS)
+      semaphore_t sem_done;
+#elif defined (LGFX_JPG_PARALLEL_STD_THREAD)
+      std::thread thread;
+#endif
+    };
+
+    worker_t _worker[worker_count];
+    const lgfxJdec* _src = nullptr;
+    const std::uint8_t* _data = nullptr;
+    std::uint32_t _len = 0;
+    std::uint32_t* _offsets = nullptr;  // 各グループ先頭の再開区間のデータ位置
+    std::uint32_t _group_rows = 0;      // グループのMCU行数
+    std::uint32_t _groups = 0;
+    std::int32_t _band_width = 0;
+    std::size_t _band_len = 0;
+    std::uint_fast8_t _scale = 0;
+    std::uint_fast8_t _bytes = 0;
+    convert_t _convert = nullptr;
+    void* _param = nullptr;
+    std::atomic<bool> _abort { false };  // 出力側・各ワーカーから参照される中断フラグ
+
+    // RSTnマーカーを走査し、各グループ先頭の再開区間の位置を求める
+    bool scan_offsets(std::uint32_t mcus_x)
+    {
+      std::uint32_t intervals = _group_rows * mcus_x / _src->nrst;  // グループあたりの再開区間数
+      _offsets[0] = _src->data_ofs;
+      std::uint32_t next = 1;
+      std::uint32_t k = 0;
+      auto p = _data + _src->data_ofs;
+      auto end = _data + _len;
+      while (next < _groups && p + 1 < end) {
+        p = static_cast<const std::uint8_t*>(memchr(p, 0xFF, end - p - 1));
+        if (!p) break;
+        std::uint_fast8_t m = p[1];
+        if ((m & 0xF8) == 0xD0) {
+          if (++k == next * intervals) _offsets[next++] = p + 2 - _data;
+          p += 2;
+        } else if (m == 0xD9) {  // EOI
+          break;
+        } else {
+          p += (m == 0xFF) ? 1 : 2;  // fill byte / stuffed 0xFF00
+        }
+      }
+      return next == _groups;
+    }
+
+    static std::uint32_t read_data(lgfxJdec* jd, std::uint8_t* buf, std::uint32_t len)
+    {
+      auto w = static_cast<worker_t*>(jd->device);
+      auto o = w->owner;
+      if (len > o->_len - w->pos) len = o->_len - w->pos;
+      if (buf) memcpy(buf, o->_data + w->pos, len);
+      w->pos += len;
+      return len;
+    }
+
+    static std::uint32_t write_mcu(lgfxJdec* jd, void* bitmap, JRECT* rect)
+    {
+      auto w = static_cast<worker_t*>(jd->device);
+      auto o = w->owner;
+      std::int32_t bw = o->_band_width;
+      o->_convert(o->_param, w->index, bitmap, rect
+                 , w->dst + ((rect->top - w->dst_y) * bw + rect->left) * o->_bytes, bw);
+      if (w->dst_bottom <= (std::int32_t)rect->bottom) w->dst_bottom = rect->bottom + 1;
+      return !o->_abort;
+    }
+
+    static void run(worker_t* w)
+    {
+      auto o = w->owner;
+      std::uint32_t my = o->_src->msy << 3;
+      for (std::uint32_t g = w->index; g < o->_groups; g += worker_count) {
+        std::uint_fast8_t slot = (g / worker_count) & 1;
+        w->sem_free.take();
+        std::int32_t h = 0;
+        if (!o->_abort) {
+          w->dst = w->band[slot];
+          w->dst_y = w->dst_bottom = (g * o->_group_rows * my) >> o->_scale;
+          w->pos = o->_offsets[g];
+          JRESULT res = lgfx_jd_decomp_rows(&w->jd, write_mcu, o->_scale, g * o->_group_rows, (g + 1) * o->_group_rows);
+          if (res != JDR_OK) {
+            if (!o->_abort) w->result = res;
+            o->_abort = true;
+          }
+          h = w->dst_bottom - w->dst_y;
+        }
+        w->band_h[slot] = h;
+        w->sem_ready.give();
+      }
+    }
+
+#if defined (LGFX_JPG_PARALLEL_FREERTOS)
+    static void task_main(void* arg)
+    {
+      auto w = static_cast<worker_t*>(arg);
+      run(w);
+      w->sem_done.give();
+      vTaskDelete(nullptr);
+    }
+
+    bool start_worker(worker_t* w)
+    {
+      w->result = JDR_OK;
+      if (!w->sem_done.init(0)) return false;
+      if (pdPASS == xTaskCreatePinnedToCore(task_main, "jpg_dec", 4096, w, uxTaskPriorityGet(nullptr)
+                                           , nullptr, w->index % portNUM_PROCESSORS)) return true;
+      w->sem_done.release();
+      return false;
+    }
+
+    void join_worker(worker_t* w)
+    {
+      w->sem_done.take();
+      w->sem_done.release();
+    }
+#elif defined (LGFX_JPG_PARALLEL_STD_THREAD)
+    bool start_worker(worker_t* w)
+    {
+      w->result = JDR_OK;
+      w->thread = std::thread(run, w);
+      return true;
+    }
+
+    void join_worker(worker_t* w)
+    {
+      w->thread.join();
+    }
+#endif
+  };
+}
+
+#endif
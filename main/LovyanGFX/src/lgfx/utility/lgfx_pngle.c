@@ -102,12 +102,15 @@ struct _pngle_t {
   size_t  avail_out;
 
   // scanline decoder (reset on every set_interlace_pass() call)
-  uint8_t *scanline_ringbuf;
-  size_t scanline_ringbuf_size;
-  size_t scanline_ringbuf_cidx;
-  int_fast8_t scanline_remain_bytes_to_render;
+  // 前ラインと現ラインを連続領域で保持する。各ライン先頭に bytes_per_pixel 分の 0 を置いて左端の a,c とする
+  uint8_t *scanline_buf;
+  uint8_t *scanline_cur;
+  uint8_t *scanline_prev;
+  size_t scanline_stride;
+  size_t scanline_pos;
+  uint32_t scanline_pixels;
+  uint_fast8_t bytes_per_pixel;
   int_fast8_t filter_type;
-  uint32_t drawing_x;
   uint32_t drawing_y;
 
   // interlace
@@ -115,8 +118,7 @@ struct _pngle_t {
 
   const char *error;
 
-  // for pngle_draw_pixels
-  uint_fast8_t n_pixels;
+  // for pngle_draw_row
   uint_fast8_t pixel_depth;
   uint_fast16_t magni;
 
@@ -127,9 +129,16 @@ struct _pngle_t {
 
   pngle_init_callback_t init_callback;
   pngle_draw_callback_t draw_callback;
+  pngle_row_callback_t row_callback;
   pngle_done_callback_t done_callback;
 
   void *user_data;
+
+  pngle_arena_t *arena;
+  size_t arena_base;          // arena->used before pngle_t
+  size_t arena_mark;          // arena->used after pngle_t
+  size_t arena_overflow_base; // arena->overflow before pngle_t
+  size_t arena_overflow_mark; // arena->overflow after pngle_t
 };
 
 // magic
@@ -163,6 +172,58 @@ static inline uint32_t U32_CLAMP_ADD(uint32_t a, uint32_t b, uint32_t top)
 }
 //*/
 
+#define PNGLE_ARENA_ALIGN 8
+
+void lgfx_pngle_arena_init(pngle_arena_t *arena, void *buf, size_t size)
+{
+  uintptr_t adj = (PNGLE_ARENA_ALIGN - ((uintptr_t)buf & (PNGLE_ARENA_ALIGN - 1))) & (PNGLE_ARENA_ALIGN - 1);
+  if (!buf || size < adj) { buf = NULL; size = adj = 0; }
+  arena->buf = (uint8_t *)buf + adj;
+  arena->size = (size - adj) & ~(size_t)(PNGLE_ARENA_ALIGN - 1);
+  arena->used = 0;
+  arena->overflow = 0;
+  arena->peak = 0;
+}
+
+static inline int arena_contains(const pngle_arena_t *arena, const void *p)
+{
+  return arena && arena->buf && (const uint8_t *)p >= arena->buf && (const uint8_t *)p < arena->buf + arena->size;
+}
+
+static void arena_update_peak(pngle_arena_t *arena)
+{
+  size_t demand = arena->used + arena->overflow;
+  if (arena->peak < demand) arena->peak = demand;
+}
+
+void *lgfx_pngle_arena_alloc(pngle_arena_t *arena, size_t size)
+{
+  if (!arena) return NULL;
+  size = (size + PNGLE_ARENA_ALIGN - 1) & ~(size_t)(PNGLE_ARENA_ALIGN - 1);
+  void *p = NULL;
+  if (arena->buf && arena->size - arena->used >= size) {
+    p = arena->buf + arena->used;
+    arena->used += size;
+    memset(p, 0, size);
+  } else {
+    arena->overflow += size; // needed arena size is still accounted
+  }
+  arena_update_peak(arena);
+  return p;
+}
+
+static void *pngle_calloc(pngle_t *pngle, size_t a, size_t b, const char *name)
+{
+  PNGLE_UNUSED(name);
+  void *p = lgfx_pngle_arena_alloc(pngle->arena, a * b);
+  return p ? p : PNGLE_CALLOC(a, b, name);
+}
+
+static void pngle_free(pngle_t *pngle, void *p)
+{
+  if (p && !arena_contains(pngle->arena, p)) free(p);
+}
+
 void lgfx_pngle_reset(pngle_t *pngle)
 {
   if (!pngle) return ;
@@ -170,14 +231,20 @@ void lgfx_pngle_reset(pngle_t *pngle)
   pngle->state = PNGLE_STATE_INITIAL;
   pngle->error = "No error";
 
-  if (pngle->scanline_ringbuf) { free(pngle->scanline_ringbuf); pngle->scanline_ringbuf = NULL; }
-  if (pngle->palette         ) { free(pngle->palette         ); pngle->palette = NULL;}
-  if (pngle->trans_palette   ) { free(pngle->trans_palette   ); pngle->trans_palette = NULL; }
+  if (pngle->scanline_buf    ) { pngle_free(pngle, pngle->scanline_buf    ); pngle->scanline_buf = NULL; }
+  if (pngle->palette         ) { pngle_free(pngle, pngle->palette         ); pngle->palette = NULL;}
+  if (pngle->trans_palette   ) { pngle_free(pngle, pngle->trans_palette   ); pngle->trans_palette = NULL; }
 
 #ifndef PNGLE_NO_GAMMA_CORRECTION
-  if (pngle->gamma_table     ) { free(pngle->gamma_table     ); pngle->gamma_table = NULL; }
+  if (pngle->gamma_table     ) { pngle_free(pngle, pngle->gamma_table     ); pngle->gamma_table = NULL; }
 #endif
 
+  // 以降に確保された領域はすべて解放済みとして巻き戻す
+  if (pngle->arena) {
+    pngle->arena->used = pngle->arena_mark;
+    pngle->arena->overflow = pngle->arena_overflow_mark;
+  }
+
   pngle->channels = 0; // indicates IHDR hasn't been processed yet
   pngle->next_out = NULL; // indicates IDAT hasn't been processed yet
 
@@ -191,9 +258,22 @@ void lgfx_pngle_reset(pngle_t *pngle)
 
 pngle_t *lgfx_pngle_new()
 {
-  pngle_t *pngle = (pngle_t *)PNGLE_CALLOC(1, sizeof(pngle_t), "pngle_t");
+  return lgfx_pngle_new_arena(NULL);
+}
+
+pngle_t *lgfx_pngle_new_arena(pngle_arena_t *arena)
+{
+  size_t base = arena ? arena->used : 0;
+  size_t overflow_base = arena ? arena->overflow : 0;
+  pngle_t *pngle = (pngle_t *)lgfx_pngle_arena_alloc(arena, sizeof(pngle_t));
+  if (!pngle) pngle = (pngle_t *)PNGLE_CALLOC(1, sizeof(pngle_t), "pngle_t");
   if (!pngle) return NULL;
 
+  pngle->arena = arena;
+  pngle->arena_base = base;
+  pngle->arena_mark = arena ? arena->used : 0;
+  pngle->arena_overflow_base = overflow_base;
+  pngle->arena_overflow_mark = arena ? arena->overflow : 0;
   lgfx_pngle_reset(pngle);
 
   return pngle;
@@ -203,7 +283,12 @@ void lgfx_pngle_destroy(pngle_t *pngle)
 {
   if (pngle) {
     lgfx_pngle_reset(pngle);
-    free(pngle);
+    pngle_arena_t *arena = pngle->arena;
+    if (arena) {
+      arena->used = pngle->arena_base;
+      arena->overflow = pngle->arena_overflow_base;
+    }
+    if (!arena_contains(arena, pngle)) free(pngle);
   }
 }
 
@@ -225,6 +310,20 @@ uint32_t lgfx_pngle_get_height(pngle_t *pngle)
   return pngle->hdr.height;
 }
 
+const uint8_t *lgfx_pngle_get_palette(pngle_t *pngle, size_t *n)
+{
+  if (n) *n = pngle ? pngle->n_palettes : 0;
+  if (!pngle) return NULL;
+  return pngle->palette;
+}
+
+const uint8_t *lgfx_pngle_get_trans_palette(pngle_t *pngle, size_t *n)
+{
+  if (n) *n = pngle ? pngle->n_trans_palettes : 0;
+  if (!pngle) return NULL;
+  return pngle->trans_palette;
+}
+
 pngle_ihdr_t *lgfx_pngle_get_ihdr(pngle_t *pngle)
 {
   if (!pngle) return NULL;
@@ -243,112 +342,113 @@ static uint_fast16_t check_trans_color(pngle_t *pngle, uint_fast16_t *value, siz
   return 0; // transcolor
 }
 
-static inline void scanline_ringbuf_push(pngle_t *pngle, uint_fast8_t value)
+// 確定したライン1本を出力する。row_callback があればライン単位、無ければ画素単位で draw_callback を呼ぶ
+static int pngle_draw_row(pngle_t *pngle)
 {
-  size_t cidx = pngle->scanline_ringbuf_cidx;
-  pngle->scanline_ringbuf[cidx++] = value;
-  pngle->scanline_ringbuf_cidx = (cidx != pngle->scanline_ringbuf_size) ? cidx : 0;
-
-//  pngle->scanline_ringbuf[pngle->scanline_ringbuf_cidx] = value;
-//  pngle->scanline_ringbuf_cidx = (pngle->scanline_ringbuf_cidx + 1) % pngle->scanline_ringbuf_size;
-}
+  const uint8_t *row = pngle->scanline_cur + pngle->bytes_per_pixel;
+
+  if (pngle->row_callback && !pngle->hdr.interlace) {
+    // パレットに無い色番号は画素単位の出力と同様にエラーとする (パレットが全色分ある場合は検査不要)
+    if (pngle->hdr.color_type == 3 && pngle->n_palettes < (1UL << pngle->hdr.depth)) {
+      uint_fast8_t depth = pngle->hdr.depth;
+      uint_fast8_t mask = ((1UL << depth) - 1);
+      uint32_t i = 0;
+      do {
+        uint32_t bit = i * depth;
+        uint_fast16_t pidx = (row[bit >> 3] >> (8 - depth - (bit & 7))) & mask;
+        if (pidx >= pngle->n_palettes) return PNGLE_ERROR("Color index is out of range");
+      } while (++i < pngle->scanline_pixels);
+    }
+    pngle->row_callback(pngle, pngle->drawing_y, row, pngle->scanline_pixels);
+    return 0;
+  }
 
-static int pngle_draw_pixels(pngle_t *pngle, size_t scanline_ringbuf_xidx, uint_fast16_t v[], uint8_t rgba[])
-{
-  uint_fast8_t n_pixels = pngle->n_pixels;
+  if (!pngle->draw_callback) return 0;
 
-  if (pngle->draw_callback) {
-    uint_fast8_t bitcount = 0;
+  uint_fast16_t v[4]; // MAX_CHANNELS
+  uint8_t rgba[4];
+  uint_fast8_t depth = pngle->hdr.depth;
+  uint_fast8_t ce = pngle->channels;
+  uint_fast8_t bitcount = 0;
+  uint32_t drawing_x = interlace_off_x[pngle->interlace_pass];
+  uint_fast8_t div_x = interlace_div_x[pngle->interlace_pass];
+  uint32_t n = pngle->scanline_pixels;
 
-    do {
-      uint_fast8_t c = 0;
-      uint_fast8_t ce = pngle->channels;
-      if (pngle->hdr.depth >= 8) {
-        if (pngle->hdr.depth == 8) {
-          do {
-            v[c] = pngle->scanline_ringbuf[scanline_ringbuf_xidx];
-            scanline_ringbuf_xidx = (scanline_ringbuf_xidx + 1) % pngle->scanline_ringbuf_size;
-          } while (++c < ce);
-        } else { // depth == 16
-          do {
-            v[c] = pngle->scanline_ringbuf[scanline_ringbuf_xidx] << 8 | pngle->scanline_ringbuf[scanline_ringbuf_xidx + 1];
-            scanline_ringbuf_xidx = (scanline_ringbuf_xidx + 2) % pngle->scanline_ringbuf_size;
-          } while (++c < ce);
-        }
-      } else {
-        uint_fast8_t mask = ((1UL << pngle->hdr.depth) - 1);
-        do {
-          bitcount += pngle->hdr.depth;
-          uint_fast8_t shift = (8 - bitcount);
-          v[c] = (pngle->scanline_ringbuf[scanline_ringbuf_xidx] >> shift) & mask;
-          if (bitcount == 8) {
-            bitcount = 0;
-            scanline_ringbuf_xidx = (scanline_ringbuf_xidx + 1) % pngle->scanline_ringbuf_size;
-          }
-        } while (++c < ce);
+  do {
+    uint_fast8_t c = 0;
+    if (depth >= 8) {
+      if (depth == 8) {
+        do { v[c] = *row++; } while (++c < ce);
+      } else { // depth == 16
+        do { v[c] = row[0] << 8 | row[1]; row += 2; } while (++c < ce);
       }
-
-      // color type: 0000 0111
-      //                     ^-- indexed color (palette)
-      //                    ^--- Color
-      //                   ^---- Alpha channel
-
-      if (pngle->hdr.color_type & 2) {
-        // color
-        if (pngle->hdr.color_type & 1) {
-          // indexed color: type 3
-
-          // lookup palette info
-          uint_fast16_t pidx = v[0];
-          if (pidx >= pngle->n_palettes) return PNGLE_ERROR("Color index is out of range");
-
-          v[0] = pngle->palette[pidx * 3 + 0];
-          v[1] = pngle->palette[pidx * 3 + 1];
-          v[2] = pngle->palette[pidx * 3 + 2];
-
-          // tRNS as an indexed alpha value table (for color type 3)
-          v[3] = pidx < pngle->n_trans_palettes ? pngle->trans_palette[pidx] : ~0;
-        } else {
-          // true color: 2, and 6
-          v[3] = (pngle->hdr.color_type & 4) ? v[3] : check_trans_color(pngle, v, 3);
+    } else {
+      uint_fast8_t mask = ((1UL << depth) - 1);
+      do {
+        bitcount += depth;
+        v[c] = (*row >> (8 - bitcount)) & mask;
+        if (bitcount == 8) {
+          bitcount = 0;
+          ++row;
         }
-      } else {
-        // alpha, tRNS, or opaque:  type 0, 4
-        v[3] = (pngle->hdr.color_type & 4) ? v[1] : check_trans_color(pngle, v, 1);
+      } while (++c < ce);
+    }
+
+    // color type: 0000 0111
+    //                     ^-- indexed color (palette)
+    //                    ^--- Color
+    //                   ^---- Alpha channel
+
+    if (pngle->hdr.color_type & 2) {
+      // color
+      if (pngle->hdr.color_type & 1) {
+        // indexed color: type 3
+
+        // lookup palette info
+        uint_fast16_t pidx = v[0];
+        if (pidx >= pngle->n_palettes) return PNGLE_ERROR("Color index is out of range");
+
+        v[0] = pngle->palette[pidx * 3 + 0];
+        v[1] = pngle->palette[pidx * 3 + 1];
+        v[2] = pngle->palette[pidx * 3 + 2];
 
-        // monochrome
-        v[1] = v[2] = v[0];
+        // tRNS as an indexed alpha value table (for color type 3)
+        v[3] = pidx < pngle->n_trans_palettes ? pngle->trans_palette[pidx] : ~0;
+      } else {
+        // true color: 2, and 6
+        v[3] = (pngle->hdr.color_type & 4) ? v[3] : check_trans_color(pngle, v, 3);
       }
+    } else {
+      // alpha, tRNS, or opaque:  type 0, 4
+      v[3] = (pngle->hdr.color_type & 4) ? v[1] : check_trans_color(pngle, v, 1);
+
+      // monochrome
+      v[1] = v[2] = v[0];
+    }
 
-      if (v[3]) { // transparent check
-        uint_fast8_t pixel_depth = pngle->pixel_depth;
-        uint_fast16_t magni = pngle->magni;
-        rgba[0] = ((v[0] * magni) >> pixel_depth);
-        rgba[1] = ((v[1] * magni) >> pixel_depth);
-        rgba[2] = ((v[2] * magni) >> pixel_depth);
-        rgba[3] = ((v[3] * magni) >> pixel_depth);
+    if (v[3]) { // transparent check
+      uint_fast8_t pixel_depth = pngle->pixel_depth;
+      uint_fast16_t magni = pngle->magni;
+      rgba[0] = ((v[0] * magni) >> pixel_depth);
+      rgba[1] = ((v[1] * magni) >> pixel_depth);
+      rgba[2] = ((v[2] * magni) >> pixel_depth);
+      rgba[3] = ((v[3] * magni) >> pixel_depth);
 
 #ifndef PNGLE_NO_GAMMA_CORRECTION
-        if (pngle->gamma_table) {
-          for (int i = 0; i < 3; i++) {
-            rgba[i] = pngle->gamma_table[v[i]];
-          }
+      if (pngle->gamma_table) {
+        for (int i = 0; i < 3; i++) {
+          rgba[i] = pngle->gamma_table[v[i]];
         }
-#endif
-        pngle->draw_callback(pngle, pngle->drawing_x, pngle->drawing_y, rgba);
       }
-      pngle->drawing_x += interlace_div_x[pngle->interlace_pass];
-    } while (--n_pixels && pngle->drawing_x < pngle->hdr.width);
-
-    return 0;
-  }
+#endif
+      pngle->draw_callback(pngle, drawing_x, pngle->drawing_y, rgba);
+    }
+    drawing_x += div_x;
+  } while (--n);
 
-  do {
-    pngle->drawing_x += interlace_div_x[pngle->interlace_pass];
-  } while (--n_pixels && pngle->drawing_x < pngle->hdr.width);
   return 0;
 }
-//*/
+
 
 static inline int paeth(int a, int b, int c)
 {
@@ -367,20 +467,28 @@ static int set_interlace_pass(pngle_t *pngle, uint_fast8_t pass)
   pngle->interlace_pass = pass;
 
   uint_fast8_t bytes_per_pixel = (pngle->channels * pngle->hdr.depth + 7) >> 3; // 1 if depth <= 8
-  size_t scanline_pixels = (pngle->hdr.width - interlace_off_x[pass] + interlace_div_x[pass] - 1) / interlace_div_x[pass];
+  size_t scanline_pixels = (pngle->hdr.width < interlace_off_x[pass]) ? 0
+                         : (pngle->hdr.width - interlace_off_x[pass] + interlace_div_x[pass] - 1) / interlace_div_x[pass];
   size_t scanline_stride = (scanline_pixels * pngle->channels * pngle->hdr.depth + 7) >> 3;
 
-  pngle->scanline_ringbuf_size = scanline_stride + bytes_per_pixel * 2; // 2 rooms for c/x and a
-
-  if (pngle->scanline_ringbuf) free(pngle->scanline_ringbuf);
-  if ((pngle->scanline_ringbuf = PNGLE_CALLOC(pngle->scanline_ringbuf_size, 1, "scanline ringbuf")) == NULL) return PNGLE_ERROR("Insufficient memory");
+  pngle->bytes_per_pixel = bytes_per_pixel;
+  pngle->scanline_pixels = scanline_pixels;
+  pngle->scanline_stride = scanline_stride;
+
+  size_t line_size = scanline_stride + bytes_per_pixel; // 1 room for a and c
+  if (pngle->scanline_buf) {
+    memset(pngle->scanline_buf, 0, line_size * 2);
+  } else {
+    // 全パスで共用する。全幅のライン (パス0 / 7) が最大
+    size_t max_size = ((pngle->hdr.width * pngle->channels * pngle->hdr.depth + 7) >> 3) + bytes_per_pixel;
+    if ((pngle->scanline_buf = pngle_calloc(pngle, max_size, 2, "scanline buf")) == NULL) return PNGLE_ERROR("Insufficient memory");
+  }
+  pngle->scanline_cur  = pngle->scanline_buf;
+  pngle->scanline_prev = pngle->scanline_buf + line_size;
 
-  pngle->drawing_x = interlace_off_x[pass];
   pngle->drawing_y = interlace_off_y[pass];
   pngle->filter_type = -1;
-
-  pngle->scanline_ringbuf_cidx = 0;
-  pngle->scanline_remain_bytes_to_render = -1;
+  pngle->scanline_pos = 0;
 
   return 0;
 }
@@ -388,7 +496,7 @@ static int set_interlace_pass(pngle_t *pngle, uint_fast8_t pass)
 static int setup_gamma_table(pngle_t *pngle, uint32_t png_gamma)
 {
 #ifndef PNGLE_NO_GAMMA_CORRECTION
-  if (pngle->gamma_table) free(pngle->gamma_table);
+  if (pngle->gamma_table) pngle_free(pngle, pngle->gamma_table);
 
   if (pngle->display_gamma <= 0) return 0; // disable gamma correction
   if (png_gamma == 0) return 0;
@@ -396,7 +504,7 @@ static int setup_gamma_table(pngle_t *pngle, uint32_t png_gamma)
   uint_fast8_t pixel_depth = pngle->pixel_depth;
   uint_fast16_t maxval = (1UL << pixel_depth) - 1;
 
-  pngle->gamma_table = PNGLE_CALLOC(1, maxval + 1, "gamma table");
+  pngle->gamma_table = pngle_calloc(pngle, 1, maxval + 1, "gamma table");
   if (!pngle->gamma_table) return PNGLE_ERROR("Insufficient memory");
 
   for (int i = 0; i < maxval + 1; i++) {
@@ -415,20 +523,8 @@ static int pngle_on_data(pngle_t *pngle, const uint8_t *p, int len)
 {
   const uint8_t *ep = p + len;
 
-  uint_fast8_t bytes_per_pixel = (pngle->channels * pngle->hdr.depth + 7) >> 3; // 1 if depth <= 8
-  uint_fast16_t v[4]; // MAX_CHANNELS
-  uint8_t rgba[4];
-
   while (p < ep) {
-    if (pngle->drawing_x >= pngle->hdr.width) {
-      // New row
-      pngle->drawing_x = interlace_off_x[pngle->interlace_pass];
-      pngle->drawing_y += interlace_div_y[pngle->interlace_pass];
-//      pngle->drawing_y = U32_CLAMP_ADD(pngle->drawing_y, interlace_div_y[pngle->interlace_pass], pngle->hdr.height);
-      pngle->filter_type = -1; // Indicate new line
-    }
-
-    if (pngle->drawing_x >= pngle->hdr.width || pngle->drawing_y >= pngle->hdr.height) {
+    if (pngle->scanline_pixels == 0 || pngle->drawing_y >= pngle->hdr.height) {
       if (pngle->interlace_pass == 0 || pngle->interlace_pass >= 7) return len; // Do nothing further
 
       // Interlace: Next pass
@@ -445,44 +541,39 @@ static int pngle_on_data(pngle_t *pngle, const uint8_t *p, int len)
       }
 
       pngle->filter_type = (int_fast8_t)*p++; // 0 - 4
-
-      // push sentinel bytes for new line
-      for (uint_fast8_t i = 0; i < bytes_per_pixel; i++) {
-        scanline_ringbuf_push(pngle, 0);
-      }
-
       continue;
     }
 
-    size_t cidx =  pngle->scanline_ringbuf_cidx;
-    size_t bidx = (cidx                                + bytes_per_pixel) % pngle->scanline_ringbuf_size;
-    size_t aidx = (cidx + pngle->scanline_ringbuf_size - bytes_per_pixel) % pngle->scanline_ringbuf_size;
-    // debug_printf("[pngle] cidx = %zd, bidx = %zd, aidx = %zd\n", cidx, bidx, aidx);
-
-    uint_fast8_t c = pngle->scanline_ringbuf[cidx]; // left-up
-    uint_fast8_t b = pngle->scanline_ringbuf[bidx]; // up
-    uint_fast8_t a = pngle->scanline_ringbuf[aidx]; // left
-    uint_fast8_t x = *p++; // target
-    // debug_printf("[pngle] c = 0x%02x, b = 0x%02x, a = 0x%02x, x = 0x%02x\n", c, b, a, x);
+    // 入力に届いている分をまとめてフィルタ解除する
+    size_t pos = pngle->scanline_pos;
+    size_t n = MIN(pngle->scanline_stride - pos, (size_t)(ep - p));
+    size_t bpp = pngle->bytes_per_pixel;
+    uint8_t *x = pngle->scanline_cur + bpp + pos;        // target, x[-bpp] : left
+    const uint8_t *b = pngle->scanline_prev + bpp + pos; // up,     b[-bpp] : left-up
 
     // Reverse the filter
+    size_t i = 0;
     switch (pngle->filter_type) {
-    case 0: break; // None
-    case 1: x += a; break; // Sub
-    case 2: x += b; break; // Up
-    case 3: x += (a + b) >> 1; break; // Average
-    case 4: x += paeth(a, b, c); break; // Paeth
+    case 0: memcpy(x, p, n); break; // None
+    case 1: for (; i < n; ++i) x[i] = p[i] + x[i - bpp]; break; // Sub
+    case 2: for (; i < n; ++i) x[i] = p[i] + b[i]; break; // Up
+    case 3: for (; i < n; ++i) x[i] = p[i] + ((x[i - bpp] + b[i]) >> 1); break; // Average
+    case 4: for (; i < n; ++i) x[i] = p[i] + paeth(x[i - bpp], b[i], b[i - bpp]); break; // Paeth
     }
+    p += n;
+    pngle->scanline_pos = (pos += n);
 
-    scanline_ringbuf_push(pngle, x); // updates scanline_ringbuf_cidx
+    if (pos == pngle->scanline_stride) {
+      if (pngle_draw_row(pngle) < 0) return -1;
 
-    if (pngle->scanline_remain_bytes_to_render < 0) pngle->scanline_remain_bytes_to_render = bytes_per_pixel;
-    if (--pngle->scanline_remain_bytes_to_render == 0) {
-      size_t xidx = (pngle->scanline_ringbuf_cidx + pngle->scanline_ringbuf_size - bytes_per_pixel) % pngle->scanline_ringbuf_size;
-
-      if (pngle_draw_pixels(pngle, xidx, v, rgba) < 0) return -1;
-
-      pngle->scanline_remain_bytes_to_render = -1; // reset
+      // New row
+      uint8_t *tmp = pngle->scanline_prev;
+      pngle->scanline_prev = pngle->scanline_cur;
+      pngle->scanline_cur = tmp;
+      pngle->scanline_pos = 0;
+      pngle->drawing_y += interlace_div_y[pngle->interlace_pass];
+//      pngle->drawing_y = U32_CLAMP_ADD(pngle->drawing_y, interlace_div_y[pngle->interlace_pass], pngle->hdr.height);
+      pngle->filter_type = -1; // Indicate new line
     }
   }
 
@@ -512,8 +603,6 @@ static int pngle_handle_chunk(pngle_t *pngle, const uint8_t *buf, size_t len)
 
     pngle->pixel_depth = (pngle->hdr.color_type & 1) ? 8 : pngle->hdr.depth;
 
-    pngle->n_pixels = (pngle->hdr.depth & 7) ? (8 / pngle->hdr.depth) : 1;
-
     pngle->magni = (pngle->pixel_depth == 1) ? 0x1FF
                  : (pngle->pixel_depth == 2) ? 0x155
                  : (pngle->pixel_depth == 4) ? 0x111
@@ -742,7 +831,7 @@ static int pngle_feed_internal(pngle_t *pngle, const uint8_t *buf, size_t len)
       uint32_t chunk_remain_3 = pngle->chunk_remain / 3;
       if (pngle->chunk_remain != chunk_remain_3 * 3) return PNGLE_ERROR("Invalid PLTE chunk size");
       if (chunk_remain_3 > MIN(256, (1UL << pngle->hdr.depth))) return PNGLE_ERROR("Too many palettes in PLTE");
-      if ((pngle->palette = PNGLE_CALLOC(chunk_remain_3, 3, "palette")) == NULL) return PNGLE_ERROR("Insufficient memory");
+      if ((pngle->palette = pngle_calloc(pngle, chunk_remain_3, 3, "palette")) == NULL) return PNGLE_ERROR("Insufficient memory");
       pngle->n_palettes = 0;
       break;
 
@@ -770,7 +859,7 @@ static int pngle_feed_internal(pngle_t *pngle, const uint8_t *buf, size_t len)
       default:
         return PNGLE_ERROR("tRNS chunk is prohibited on the color type");
       }
-      if ((pngle->trans_palette = PNGLE_CALLOC(pngle->chunk_remain, 1, "trans palette")) == NULL) return PNGLE_ERROR("Insufficient memory");
+      if ((pngle->trans_palette = pngle_calloc(pngle, pngle->chunk_remain, 1, "trans palette")) == NULL) return PNGLE_ERROR("Insufficient memory");
       pngle->n_trans_palettes = 0;
       break;
 
@@ -864,6 +953,12 @@ void lgfx_pngle_set_draw_callback(pngle_t *pngle, pngle_draw_callback_t callback
   pngle->draw_callback = callback;
 }
 
+void lgfx_pngle_set_row_callback(pngle_t *pngle, pngle_row_callback_t callback)
+{
+  if (!pngle) return ;
+  pngle->row_callback = callback;
+}
+
 void lgfx_pngle_set_done_callback(pngle_t *pngle, pngle_done_callback_t callback)
 {
   if (!pngle) return ;
@@ -35,6 +35,7 @@
 #define PNGLE_NO_GAMMA_CORRECTION 1
 
 #include <stdint.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,12 +47,29 @@ typedef struct _pngle_t pngle_t;
 // Callback signatures
 typedef void (*pngle_init_callback_t)(pngle_t *pngle, uint32_t w, uint32_t h, uint_fast8_t hasTransparent);
 typedef void (*pngle_draw_callback_t)(pngle_t *pngle, uint32_t x, uint32_t y, uint8_t rgba[4]);
+// row: defiltered scanline in PNG native format (packed bits / RGB / index / 16bit big endian), width: pixel count
+typedef void (*pngle_row_callback_t)(pngle_t *pngle, uint32_t y, const uint8_t *row, uint32_t width);
 typedef void (*pngle_done_callback_t)(pngle_t *pngle);
 
+// Arena: caller-provided work area (static array or PSRAM).
+// pngle_t (about 44KB incl. the inflate window) and its buffers are taken from here, and
+// released all at once when the pngle is destroyed. Requests that do not fit fall back to calloc.
+typedef struct _pngle_arena_t {
+  uint8_t *buf;
+  size_t size;
+  size_t used;     // bytes in use
+  size_t overflow; // bytes currently served by calloc because the arena was full
+  size_t peak;     // high water mark of used + overflow (arena size needed to avoid calloc)
+} pngle_arena_t;
+
+void lgfx_pngle_arena_init(pngle_arena_t *arena, void *buf, size_t size); // buf may be NULL (measure only)
+void *lgfx_pngle_arena_alloc(pngle_arena_t *arena, size_t size); // zero filled, NULL if it does not fit
+
 // ----------------
 // Basic interfaces
 // ----------------
 pngle_t *lgfx_pngle_new();
+pngle_t *lgfx_pngle_new_arena(pngle_arena_t *arena);
 void lgfx_pngle_destroy(pngle_t *pngle);
 void lgfx_pngle_reset(pngle_t *pngle); // clear its internal state (not applied to pngle_set_* functions)
 const char *lgfx_pngle_error(pngle_t *pngle);
@@ -64,11 +82,21 @@ void lgfx_pngle_set_init_callback(pngle_t *png, pngle_init_callback_t callback);
 void lgfx_pngle_set_draw_callback(pngle_t *png, pngle_draw_callback_t callback);
 void lgfx_pngle_set_done_callback(pngle_t *png, pngle_done_callback_t callback);
 
+// row callback takes precedence over draw callback for non-interlaced images.
+// no palette lookup, tRNS and gamma are applied; use lgfx_pngle_get_palette / lgfx_pngle_get_trans_palette.
+void lgfx_pngle_set_row_callback(pngle_t *png, pngle_row_callback_t callback);
+
 void lgfx_pngle_set_display_gamma(pngle_t *pngle, double display_gamma); // enables gamma correction by specifying display gamma, typically 2.2. No effect when gAMA chunk is missing
 
 void lgfx_pngle_set_user_data(pngle_t *pngle, void *user_data);
 void *lgfx_pngle_get_user_data(pngle_t *pngle);
 
+// PLTE: RGB triplets, *n = number of entries
+const uint8_t *lgfx_pngle_get_palette(pngle_t *pngle, size_t *n);
+// tRNS: alpha per palette entry (color type 3, *n = number of entries)
+//       or 16bit big endian transparent color (color type 0 / 2, *n = 1)
+const uint8_t *lgfx_pngle_get_trans_palette(pngle_t *pngle, size_t *n);
+
 
 // ----------------
 // Debug interfaces
@@ -113,7 +113,7 @@ static const uint8_t Clip8[1024] = {
 	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
-#else	/* JD_TBLCLIP */
+#endif	/* JD_TBLCLIP */
 
 static inline int32_t BYTECLIP (
 	int32_t val
@@ -124,6 +124,11 @@ static inline int32_t BYTECLIP (
 	return val;
 }
 
+/* Saturation selected at run time (tbl is a constant in each expansion of the callers) */
+#if JD_TBLCLIP
+#define CLIP8(v, tbl) ((tbl) ? Clip8[(uint32_t)(v) & 0x3FF] : BYTECLIP(v))
+#else
+#define CLIP8(v, tbl) BYTECLIP(v)
 #endif
 
 
@@ -263,13 +268,13 @@ static int32_t bitext (	/* >=0: extracted data, <0: error code */
 			uint8_t *dpend = jd->dpend;
 			if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 				dp = jd->inbuf;	/* Top of input buffer */
-				jd->dpend = dpend = dp + jd->infunc(jd, dp, JD_SZBUF);
+				jd->dpend = dpend = dp + jd->infunc(jd, dp, jd->sz_buf);
 				if (dp == dpend) return 0 - (int32_t)JDR_INP;	/* Err: read error or wrong stream termination */
 			}
 			if (*dp == 0xff) {		/* Is start of flag sequence? */
 				if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 					dp = jd->inbuf;	/* Top of input buffer */
-					jd->dpend = dpend = dp + jd->infunc(jd, dp, JD_SZBUF);
+					jd->dpend = dpend = dp + jd->infunc(jd, dp, jd->sz_buf);
 					if (dp == dpend) return 0 - (int32_t)JDR_INP;	/* Err: read error or wrong stream termination */
 				}
 				if (*dp != 0) return 0 - (int32_t)JDR_FMT1;	/* Err: unexpected flag is detected (may be collapted data) */
@@ -313,13 +318,13 @@ static int32_t huffext (	/* >=0: decoded data, <0: error code */
 			uint8_t *dpend = jd->dpend;
 			if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 				dp = jd->inbuf;	/* Top of input buffer */
-				jd->dpend = dpend = dp + jd->infunc(jd, dp, JD_SZBUF);
+				jd->dpend = dpend = dp + jd->infunc(jd, dp, jd->sz_buf);
 				if (dp == dpend) return 0 - (int32_t)JDR_INP;	/* Err: read error or wrong stream termination */
 			}
 			if (*dp == 0xff) {		/* Is start of flag sequence? */
 				if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 					dp = jd->inbuf;	/* Top of input buffer */
-					jd->dpend = dpend = dp + jd->infunc(jd, dp, JD_SZBUF);
+					jd->dpend = dpend = dp + jd->infunc(jd, dp, jd->sz_buf);
 					if (dp == dpend) return 0 - (int32_t)JDR_INP;	/* Err: read error or wrong stream termination */
 				}
 				if (*dp != 0) return 0 - (int32_t)JDR_FMT1;	/* Err: unexpected flag is detected (may be collapted data) */
@@ -353,9 +358,10 @@ huffext_match:
 /* Apply Inverse-DCT in Arai Algorithm (see also aa_idct.png)            */
 /*-----------------------------------------------------------------------*/
 
-static void block_idct (
+static inline __attribute__((always_inline)) void block_idct_body (
 	int32_t* src,	/* Input block data (de-quantized and pre-scaled for Arai Algorithm) */
-	uint8_t* dst	/* Pointer to the destination to store the block as byte array */
+	uint8_t* dst,	/* Pointer to the destination to store the block as byte array */
+	uint_fast8_t tbl	/* 1=Use table for saturation (constant) */
 )
 {
 	const int32_t M13 = (int32_t)(1.41421*256), M2 = (int32_t)(1.08239*256), M4 = (int32_t)(2.61313*256), M5 = (int32_t)(1.84776*256);
@@ -454,47 +460,70 @@ static void block_idct (
 
 		/* Descale the transformed values 8 bits and output */
 #if defined (ESP32) || defined (CONFIG_IDF_TARGET_ESP32) || defined (ESP_PLATFORM)
-		int32_t d0 = (v0 + v7) >> 8;
-		int32_t d7 = (v0 - v7) >> 8;
-		int32_t d1 = (v1 + v6) >> 8;
-		int32_t d6 = (v1 - v6) >> 8;
-		int32_t d2 = (v2 + v5) >> 8;
-		int32_t d5 = (v2 - v5) >> 8;
-		int32_t d3 = (v3 + v4) >> 8;
-		int32_t d4 = (v3 - v4) >> 8;
-
-		if (d0 < 0) d0 = 0; else if (d0 > 255) d0 = 255;
-		if (d1 < 0) d1 = 0; else if (d1 > 255) d1 = 255;
-		if (d2 < 0) d2 = 0; else if (d2 > 255) d2 = 255;
-		if (d3 < 0) d3 = 0; else if (d3 > 255) d3 = 255;
-		if (d4 < 0) d4 = 0; else if (d4 > 255) d4 = 255;
-		if (d5 < 0) d5 = 0; else if (d5 > 255) d5 = 255;
-		if (d6 < 0) d6 = 0; else if (d6 > 255) d6 = 255;
-		if (d7 < 0) d7 = 0; else if (d7 > 255) d7 = 255;
-
-		dst[0] = d0;
-		dst[1] = d1;
-		dst[2] = d2;
-		dst[3] = d3;
-		dst[4] = d4;
-		dst[5] = d5;
-		dst[6] = d6;
-		dst[7] = d7;
+		if (tbl) {
+			dst[0] = CLIP8((v0 + v7) >> 8, 1);
+			dst[7] = CLIP8((v0 - v7) >> 8, 1);
+			dst[1] = CLIP8((v1 + v6) >> 8, 1);
+			dst[6] = CLIP8((v1 - v6) >> 8, 1);
+			dst[2] = CLIP8((v2 + v5) >> 8, 1);
+			dst[5] = CLIP8((v2 - v5) >> 8, 1);
+			dst[3] = CLIP8((v3 + v4) >> 8, 1);
+			dst[4] = CLIP8((v3 - v4) >> 8, 1);
+		} else {
+			int32_t d0 = (v0 + v7) >> 8;
+			int32_t d7 = (v0 - v7) >> 8;
+			int32_t d1 = (v1 + v6) >> 8;
+			int32_t d6 = (v1 - v6) >> 8;
+			int32_t d2 = (v2 + v5) >> 8;
+			int32_t d5 = (v2 - v5) >> 8;
+			int32_t d3 = (v3 + v4) >> 8;
+			int32_t d4 = (v3 - v4) >> 8;
+
+			if (d0 < 0) d0 = 0; else if (d0 > 255) d0 = 255;
+			if (d1 < 0) d1 = 0; else if (d1 > 255) d1 = 255;
+			if (d2 < 0) d2 = 0; else if (d2 > 255) d2 = 255;
+			if (d3 < 0) d3 = 0; else if (d3 > 255) d3 = 255;
+			if (d4 < 0) d4 = 0; else if (d4 > 255) d4 = 255;
+			if (d5 < 0) d5 = 0; else if (d5 > 255) d5 = 255;
+			if (d6 < 0) d6 = 0; else if (d6 > 255) d6 = 255;
+			if (d7 < 0) d7 = 0; else if (d7 > 255) d7 = 255;
+
+			dst[0] = d0;
+			dst[1] = d1;
+			dst[2] = d2;
+			dst[3] = d3;
+			dst[4] = d4;
+			dst[5] = d5;
+			dst[6] = d6;
+			dst[7] = d7;
+		}
 #else
-		dst[0] = BYTECLIP((v0 + v7) >> 8);
-		dst[7] = BYTECLIP((v0 - v7) >> 8);
-		dst[1] = BYTECLIP((v1 + v6) >> 8);
-		dst[6] = BYTECLIP((v1 - v6) >> 8);
-		dst[2] = BYTECLIP((v2 + v5) >> 8);
-		dst[5] = BYTECLIP((v2 - v5) >> 8);
-		dst[3] = BYTECLIP((v3 + v4) >> 8);
-		dst[4] = BYTECLIP((v3 - v4) >> 8);
+		dst[0] = CLIP8((v0 + v7) >> 8, tbl);
+		dst[7] = CLIP8((v0 - v7) >> 8, tbl);
+		dst[1] = CLIP8((v1 + v6) >> 8, tbl);
+		dst[6] = CLIP8((v1 - v6) >> 8, tbl);
+		dst[2] = CLIP8((v2 + v5) >> 8, tbl);
+		dst[5] = CLIP8((v2 - v5) >> 8, tbl);
+		dst[3] = CLIP8((v3 + v4) >> 8, tbl);
+		dst[4] = CLIP8((v3 - v4) >> 8, tbl);
 #endif
 		dst += 8;
 		src += 8;	/* Next row */
 	}
 }
 
+static void block_idct (int32_t* src, uint8_t* dst)
+{
+	block_idct_body(src, dst, 0);
+}
+
+#if JD_TBLCLIP
+static void block_idct_tbl (int32_t* src, uint8_t* dst)
+{
+	block_idct_body(src, dst, 1);
+}
+#endif
+
 
 
 
@@ -564,6 +593,9 @@ static JRESULT mcu_load (
 		if (JD_USE_SCALE && jd->scale == 3) {
 			*bp = (uint8_t)((*tmp >> 8) + 128);	/* If scale ratio is 1/8, IDCT can be ommited and only DC element is used */
 		} else {
+#if JD_TBLCLIP
+			if (jd->tblclip) block_idct_tbl(tmp, bp); else
+#endif
 			block_idct(tmp, bp);		/* Apply IDCT and store the block to the MCU buffer */
 		}
 
@@ -576,6 +608,77 @@ static JRESULT mcu_load (
 
 
 
+/*-----------------------------------------------------------------------*/
+/* Build an RGB MCU from discrete comopnents                             */
+/*-----------------------------------------------------------------------*/
+
+static inline __attribute__((always_inline)) void mcu_build (
+	lgfxJdec* jd,		/* Pointer to the decompressor object */
+	uint8_t* dst,		/* Output buffer */
+	uint32_t mx,		/* MCU size (pixel) */
+	uint32_t my,
+	uint_fast8_t tbl,	/* 1=Use table for saturation (constant) */
+	uint_fast8_t sw		/* 1=Output in byte swapped RGB565 directly (constant) */
+)
+{
+	const int_fast16_t FP_SHIFT = 8;
+	uint32_t ix, iy;
+	int32_t yy, cb, cr;
+	uint8_t *py, *pc;
+
+	uint_fast8_t ixshift = (mx == 16);
+	uint_fast8_t iyshift = (my == 16);
+
+	iy = 0;
+	do {
+#if JD_BAYER
+		const int_fast8_t* btbl = &Bayer[(iy & 3) << 2];
+#endif
+		py = &jd->mcubuf[((iy & 8) + iy) << 3];
+		pc = &jd->mcubuf[((mx << iyshift) + (iy >> iyshift)) << 3];
+		ix = 0;
+		do {
+			do {
+				cb = (pc[ 0] - 128); 	/* Get Cb/Cr component and restore right level */
+				cr = (pc[64] - 128);
+				++pc;
+
+			/* Convert CbCr to RGB */
+				uint_fast16_t rr = ((int32_t)(1.402   * (1<<FP_SHIFT)) * cr) >> FP_SHIFT;
+				uint_fast16_t gg = ((int32_t)(0.34414 * (1<<FP_SHIFT)) * cb
+								  + (int32_t)(0.71414 * (1<<FP_SHIFT)) * cr) >> FP_SHIFT;
+				uint_fast16_t bb = ((int32_t)(1.772   * (1<<FP_SHIFT)) * cb) >> FP_SHIFT;
+				do {
+#if JD_BAYER
+					yy = *py + btbl[ix & 3];		/* Get Y component */
+#else
+					yy = *py;					/* Get Y component */
+#endif
+					++py;
+				/* Convert YCbCr to RGB */
+					if (sw) {
+						uint_fast8_t r = CLIP8(yy + rr, tbl);
+						uint_fast8_t g = CLIP8(yy - gg, tbl);
+						uint_fast8_t b = CLIP8(yy + bb, tbl);
+						dst[0] = (r & 0xF8) | (g >> 5);			/* RRRRRGGG */
+						dst[1] = ((g << 3) & 0xE0) | (b >> 3);	/* GGGBBBBB */
+						dst += 2;
+					} else {
+						dst[0] = CLIP8(yy + rr, tbl);
+						dst[1] = CLIP8(yy - gg, tbl);
+						dst[2] = CLIP8(yy + bb, tbl);
+						dst += 3;
+					}
+				} while (++ix & ixshift);
+			} while (ix & 7);
+			py += 64 - 8;	/* Jump to next block if double block heigt */
+		} while (ix != mx);
+	} while (++iy < my);
+}
+
+
+
+
 /*-----------------------------------------------------------------------*/
 /* Output an MCU: Convert YCrCb to RGB and output it in RGB form         */
 /*-----------------------------------------------------------------------*/
@@ -606,50 +709,24 @@ static JRESULT mcu_output (
 	rect.top = y; rect.bottom = y + ry - 1;
 
 	uint8_t* workbuf = (uint8_t*)jd->workbuf;
+	uint_fast8_t tbl = jd->tblclip;
+	uint_fast8_t bytes = 3;	/* Bytes per pixel in the work buffer */
 
 	if (!JD_USE_SCALE || jd->scale != 3) {	/* Not for 1/8 scaling */
 
-		uint_fast8_t ixshift = (mx == 16);
-		uint_fast8_t iyshift = (my == 16);
-
 		/* Build an RGB MCU from discrete comopnents */
-		rgb24 = workbuf;
-		iy = 0;
-		do {
-#if JD_BAYER
-			const int_fast8_t* btbl = &Bayer[(iy & 3) << 2];
+		if (jd->format == 2 && !(JD_USE_SCALE && jd->scale)) {	/* Output RGB565 directly if no descaling */
+			bytes = 2;
+#if JD_TBLCLIP
+			if (tbl) mcu_build(jd, workbuf, mx, my, 1, 1); else
 #endif
-			py = &jd->mcubuf[((iy & 8) + iy) << 3];
-			pc = &jd->mcubuf[((mx << iyshift) + (iy >> iyshift)) << 3];
-			ix = 0;
-			do {
-				do {
-					cb = (pc[ 0] - 128); 	/* Get Cb/Cr component and restore right level */
-					cr = (pc[64] - 128);
-					++pc;
-
-				/* Convert CbCr to RGB */
-					uint_fast16_t rr = ((int32_t)(1.402   * (1<<FP_SHIFT)) * cr) >> FP_SHIFT;
-					uint_fast16_t gg = ((int32_t)(0.34414 * (1<<FP_SHIFT)) * cb
-									  + (int32_t)(0.71414 * (1<<FP_SHIFT)) * cr) >> FP_SHIFT;
-					uint_fast16_t bb = ((int32_t)(1.772   * (1<<FP_SHIFT)) * cb) >> FP_SHIFT;
-					do {
-#if JD_BAYER
-						yy = *py + btbl[ix & 3];		/* Get Y component */
-#else
-						yy = *py;					/* Get Y component */
+			mcu_build(jd, workbuf, mx, my, 0, 1);
+		} else {
+#if JD_TBLCLIP
+			if (tbl) mcu_build(jd, workbuf, mx, my, 1, 0); else
 #endif
-						++py;
-					/* Convert YCbCr to RGB */
-						rgb24[0] = BYTECLIP(yy + rr);
-						rgb24[1] = BYTECLIP(yy - gg);
-						rgb24[2] = BYTECLIP(yy + bb);
-						rgb24 += 3;
-					} while (++ix & ixshift);
-				} while (ix & 7);
-				py += 64 - 8;	/* Jump to next block if double block heigt */
-			} while (ix != mx);
-		} while (++iy < my);
+			mcu_build(jd, workbuf, mx, my, 0, 0);
+		}
 
 		/* Descale the MCU rectangular if needed */
 		if (JD_USE_SCALE && jd->scale) {
@@ -702,10 +779,10 @@ static JRESULT mcu_output (
 				py += 64;
 
 				/* Convert YCbCr to RGB */
-				rgb24[0] = BYTECLIP(yy + (((int32_t)(1.402   * (1<<FP_SHIFT)) * cr) >> FP_SHIFT));
-				rgb24[1] = BYTECLIP(yy - (((int32_t)(0.34414 * (1<<FP_SHIFT)) * cb
-										 + (int32_t)(0.71414 * (1<<FP_SHIFT)) * cr) >> FP_SHIFT));
-				rgb24[2] = BYTECLIP(yy + (((int32_t)(1.772   * (1<<FP_SHIFT)) * cb) >> FP_SHIFT));
+				rgb24[0] = CLIP8(yy + (((int32_t)(1.402   * (1<<FP_SHIFT)) * cr) >> FP_SHIFT), tbl);
+				rgb24[1] = CLIP8(yy - (((int32_t)(0.34414 * (1<<FP_SHIFT)) * cb
+										 + (int32_t)(0.71414 * (1<<FP_SHIFT)) * cr) >> FP_SHIFT), tbl);
+				rgb24[2] = CLIP8(yy + (((int32_t)(1.772   * (1<<FP_SHIFT)) * cb) >> FP_SHIFT), tbl);
 				rgb24 += 3;
 			} while ((ix += 8) < mx);
 		} while ((iy += 8) < my);
@@ -717,14 +794,14 @@ static JRESULT mcu_output (
 		uint8_t *s, *d;
 		s = d = workbuf;
 		for (size_t y = 1; y < ry; ++y) {
-			memcpy(d += rx * 3, s += mx * 3, rx * 3);	/* Copy effective pixels */
+			memmove(d += rx * bytes, s += mx * bytes, rx * bytes);	/* Copy effective pixels */
 		}
 	}
 
 	/* Convert RGB888 to RGB565 if needed */
-	if (JD_FORMAT == 1) {
+	if (jd->format && bytes == 3) {
 		uint8_t *s = workbuf;
-		uint16_t *d = (uint16_t*)s;
+		uint8_t *d = s;
 		uint_fast16_t w;
 		uint_fast16_t n = rx * ry;
 
@@ -732,7 +809,13 @@ static JRESULT mcu_output (
 			w = (*s++ & 0xF8) << 8;		/* RRRRR----------- */
 			w |= (*s++ & 0xFC) << 3;	/* -----GGGGGG----- */
 			w |= *s++ >> 3;				/* -----------BBBBB */
-			*d++ = w;
+			if (jd->format == 1) {
+				*(uint16_t*)d = w;
+			} else {
+				d[0] = w >> 8;
+				d[1] = w;
+			}
+			d += 2;
 		} while (--n);
 	}
 
@@ -760,7 +843,7 @@ static JRESULT restart (
 	for (int i = 0; i < 2; ++i) {
 		if (++dp == dpend) {	/* No input data is available, re-fill input buffer */
 			dp = jd->inbuf;
-			jd->dpend = dpend = dp + jd->infunc(jd, dp, JD_SZBUF);
+			jd->dpend = dpend = dp + jd->infunc(jd, dp, jd->sz_buf);
 			if (dp == dpend) return JDR_INP;
 		}
 		d = (d << 8) | *dp;	/* Get a byte */
@@ -787,6 +870,29 @@ static JRESULT restart (
 
 //#define	LDB_WORD(ptr) (uint16_t)(((uint16_t)*((uint8_t*)(ptr))<<8)|(uint16_t)*(uint8_t*)((ptr)+1))
 
+/*-----------------------------------------------------------------------*/
+/* Allocate working buffer for MCU and RGB                               */
+/*-----------------------------------------------------------------------*/
+
+static JRESULT alloc_mcubuf (
+	lgfxJdec* jd		/* Pointer to the decompressor object */
+)
+{
+	size_t n = jd->msy * jd->msx;				/* Number of Y blocks in the MCU */
+	if (!n) return JDR_FMT1;					/* Err: SOF0 has not been loaded */
+	size_t len = n * 64 * 2 + 64;				/* Allocate buffer for IDCT and RGB output */
+	if (len < 256) len = 256;					/* but at least 256 byte is required for IDCT */
+	jd->workbuf = alloc_pool(jd, len);			/* and it may occupy a part of following MCU working buffer for RGB output */
+	if (!jd->workbuf) return JDR_MEM1;			/* Err: not enough memory */
+	jd->mcubuf = (uint8_t*)alloc_pool(jd, (n + 2) * 64);	/* Allocate MCU working buffer */
+	if (!jd->mcubuf) return JDR_MEM1;			/* Err: not enough memory */
+	if (jd->comps_in_frame == 1) {
+		memset(&jd->mcubuf[64], 128, 128);		/* Cb/Cr clear ( for grayscale )*/
+	}
+	return JDR_OK;
+}
+
+
 static inline uint16_t LDB_WORD(uint8_t* ptr) {
   return ptr[0]<<8 | ptr[1];
 }
@@ -802,7 +908,6 @@ JRESULT lgfx_jd_prepare (
 {
 	uint8_t *seg;
 	uint32_t ofs;
-	size_t n;
 	int32_t rc;
 
 
@@ -819,7 +924,12 @@ JRESULT lgfx_jd_prepare (
 //	memset(jd->huffdata, 0, sizeof(uint8_t*) * 4);
 //	memset(jd->qttbl, 0, sizeof(uint32_t*) * 4);
 
-	jd->inbuf = seg = alloc_pool(jd, JD_SZBUF);		/* Allocate stream input buffer */
+	jd->format = JD_FORMAT;		/* Output format (default) */
+	jd->tblclip = 0;		/* Saturation by comparison (default) */
+
+	/* Allocate stream input buffer (the surplus of the pool is used for it) */
+	jd->sz_buf = (sz_pool > JD_SZWORK + JD_SZBUF) ? (sz_pool - JD_SZWORK) & ~(JD_SZBUF - 1) : JD_SZBUF;
+	jd->inbuf = seg = alloc_pool(jd, jd->sz_buf);
 	if (!seg) return JDR_MEM1;
 
 	if (infunc(jd, seg, 2) != 2) return JDR_INP;/* Check SOI marker */
@@ -835,7 +945,7 @@ JRESULT lgfx_jd_prepare (
 		switch (seg[1]) {	/* Marker */
 		case 0xC0:	/* SOF0 (baseline JPEG) */
 			/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > jd->sz_buf) return JDR_MEM2;
 			if (infunc(jd, seg, len) != len) return JDR_INP;
 
 			jd->width = LDB_WORD(seg+3);		/* Image width in unit of pixel */
@@ -863,7 +973,7 @@ JRESULT lgfx_jd_prepare (
 
 		case 0xDD:	/* DRI */
 			/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > jd->sz_buf) return JDR_MEM2;
 			if (infunc(jd, seg, len) != len) return JDR_INP;
 
 			/* Get restart interval (MCUs) */
@@ -872,7 +982,7 @@ JRESULT lgfx_jd_prepare (
 
 		case 0xC4:	/* DHT */
 			/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > jd->sz_buf) return JDR_MEM2;
 			if (infunc(jd, seg, len) != len) return JDR_INP;
 
 			/* Create huffman tables */
@@ -882,7 +992,7 @@ JRESULT lgfx_jd_prepare (
 
 		case 0xDB:	/* DQT */
 			/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > jd->sz_buf) return JDR_MEM2;
 			if (infunc(jd, seg, len) != len) return JDR_INP;
 
 			/* Create de-quantizer tables */
@@ -892,7 +1002,7 @@ JRESULT lgfx_jd_prepare (
 
 		case 0xDA:	/* SOS */
 			/* Load segment data */
-			if (len > JD_SZBUF) return JDR_MEM2;
+			if (len > jd->sz_buf) return JDR_MEM2;
 			if (infunc(jd, seg, len) != len) return JDR_INP;
 
 			if (!jd->width || !jd->height) return JDR_FMT1;	/* Err: Invalid image size */
@@ -913,21 +1023,13 @@ JRESULT lgfx_jd_prepare (
 			}
 
 			/* Allocate working buffer for MCU and RGB */
-			n = jd->msy * jd->msx;						/* Number of Y blocks in the MCU */
-			if (!n) return JDR_FMT1;					/* Err: SOF0 has not been loaded */
-			len = n * 64 * 2 + 64;						/* Allocate buffer for IDCT and RGB output */
-			if (len < 256) len = 256;					/* but at least 256 byte is required for IDCT */
-			jd->workbuf = alloc_pool(jd, len);			/* and it may occupy a part of following MCU working buffer for RGB output */
-			if (!jd->workbuf) return JDR_MEM1;			/* Err: not enough memory */
-			jd->mcubuf = (uint8_t*)alloc_pool(jd, (n + 2) * 64);	/* Allocate MCU working buffer */
-			if (!jd->mcubuf) return JDR_MEM1;			/* Err: not enough memory */
-			if (jd->comps_in_frame == 1) {
-				memset(&jd->mcubuf[64], 128, 128);		/* Cb/Cr clear ( for grayscale )*/
-			}
+			rc = alloc_mcubuf(jd);
+			if (rc) return (JRESULT)rc;
 
 			/* Pre-load the JPEG data to extract it from the bit stream */
-			ofs %= JD_SZBUF;						/* Align read offset to JD_SZBUF */
-			int32_t dc = infunc(jd, seg + ofs, JD_SZBUF - ofs);
+			jd->data_ofs = ofs;						/* Offset of the entropy coded data */
+			ofs %= jd->sz_buf;						/* Align read offset to the input buffer size */
+			int32_t dc = infunc(jd, seg + ofs, jd->sz_buf - ofs);
 			jd->dptr = seg + ofs - 1;
 			jd->dpend = seg + ofs + dc;
 			jd->dmsk = 0;	/* Prepare to read bit stream */
@@ -962,32 +1064,30 @@ JRESULT lgfx_jd_prepare (
 
 
 /*-----------------------------------------------------------------------*/
-/* Start to decompress the JPEG picture                                  */
+/* Decompress MCU rows                                                   */
 /*-----------------------------------------------------------------------*/
 
-JRESULT lgfx_jd_decomp (
+static JRESULT decomp_rows (
 	lgfxJdec* jd,								/* Initialized decompression object */
 	uint32_t (*outfunc)(lgfxJdec*, void*, JRECT*),	/* RGB output function */
-	uint_fast8_t scale							/* Output de-scaling factor (0 to 3) */
+	uint32_t top,								/* First MCU row */
+	uint32_t bottom,							/* MCU row to stop at */
+	uint32_t rsc								/* Next expected restart sequence number */
 )
 {
 	uint32_t x, y, mx, my;
-	uint32_t nrst, rst, rsc;
+	uint32_t nrst, rst;
 	JRESULT rc;
 
-
-	if (scale > (JD_USE_SCALE ? 3 : 0)) return JDR_PAR;
-	jd->scale = scale;
-
 	nrst = jd->nrst;
 	mx = jd->msx << 3; my = jd->msy << 3;			/* Size of the MCU (pixel) */
 
 	jd->dcv[2] = jd->dcv[1] = jd->dcv[0] = 0;	/* Initialize DC values */
-	rst = rsc = 0;
+	rst = 0;
 
 	rc = JDR_OK;
 
-	for (y = 0; y < jd->height; y += my) {		/* Vertical loop of MCUs */
+	for (y = top * my; y < jd->height && y < bottom * my; y += my) {		/* Vertical loop of MCUs */
 		x = 0;
 		do {	/* Horizontal loop of MCUs */
 			if (nrst && rst++ == nrst) {	/* Process restart interval if enabled */
@@ -1007,3 +1107,83 @@ JRESULT lgfx_jd_decomp (
 
 
 
+
+/*-----------------------------------------------------------------------*/
+/* Start to decompress the JPEG picture                                  */
+/*-----------------------------------------------------------------------*/
+
+JRESULT lgfx_jd_decomp (
+	lgfxJdec* jd,								/* Initialized decompression object */
+	uint32_t (*outfunc)(lgfxJdec*, void*, JRECT*),	/* RGB output function */
+	uint_fast8_t scale							/* Output de-scaling factor (0 to 3) */
+)
+{
+	if (scale > (JD_USE_SCALE ? 3 : 0)) return JDR_PAR;
+	jd->scale = scale;
+
+	return decomp_rows(jd, outfunc, 0, ~0u / (jd->msy << 3), 0);
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Prepare a decompressor sharing the tables of a prepared one           */
+/*-----------------------------------------------------------------------*/
+
+JRESULT lgfx_jd_share (
+	lgfxJdec* jd,			/* Blank decompressor object */
+	const lgfxJdec* src,	/* Prepared decompressor object (tables are referred, not copied) */
+	uint32_t (*infunc)(lgfxJdec*, uint8_t*, uint32_t),	/* JPEG strem input function */
+	void* pool,			/* Working buffer for input and MCU */
+	uint_fast16_t sz_pool,	/* Size of working buffer */
+	void* dev			/* I/O device identifier for the session */
+)
+{
+	if (!pool) return JDR_PAR;
+
+	*jd = *src;
+	jd->pool = (uint8_t*)pool;
+	jd->sz_pool = sz_pool;
+	jd->infunc = infunc;
+	jd->device = dev;
+
+	jd->sz_buf = JD_SZBUF;
+	jd->inbuf = alloc_pool(jd, jd->sz_buf);		/* Allocate stream input buffer */
+	if (!jd->inbuf) return JDR_MEM1;
+
+	return alloc_mcubuf(jd);
+}
+
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Decompress MCU rows starting at a restart interval                    */
+/*-----------------------------------------------------------------------*/
+
+JRESULT lgfx_jd_decomp_rows (
+	lgfxJdec* jd,								/* Initialized decompression object */
+	uint32_t (*outfunc)(lgfxJdec*, void*, JRECT*),	/* RGB output function */
+	uint_fast8_t scale,							/* Output de-scaling factor (0 to 3) */
+	uint32_t top,								/* First MCU row (must be at the head of a restart interval) */
+	uint32_t bottom								/* MCU row to stop at */
+)
+{
+	if (scale > (JD_USE_SCALE ? 3 : 0)) return JDR_PAR;
+	jd->scale = scale;
+
+	uint32_t mcus = top * ((jd->width + (jd->msx << 3) - 1) / (jd->msx << 3));	/* Number of MCUs before the top row */
+	uint32_t rsc = 0;
+	if (mcus) {
+		if (!jd->nrst || mcus % jd->nrst) return JDR_PAR;	/* Err: not at the head of a restart interval */
+		rsc = mcus / jd->nrst;
+	}
+
+	/* The input function continues from the head of the interval (next to RSTn) */
+	jd->dpend = jd->inbuf + jd->sz_buf;
+	jd->dptr = jd->dpend - 1;
+	jd->dmsk = 0;
+
+	return decomp_rows(jd, outfunc, top, bottom, rsc);
+}
@@ -13,10 +13,11 @@
 /*---------------------------------------------------------------------------*/
 /* System Configurations */
 
-#define	JD_SZBUF		512	/* Size of stream input buffer */
-#define JD_FORMAT		0	/* Output pixel format 0:RGB888 (3 BYTE/pix), 1:RGB565 (1 WORD/pix) */
+#define	JD_SZBUF		512	/* Size of stream input buffer (minimum, the surplus of the pool enlarges it in unit of JD_SZBUF) */
+#define JD_SZWORK		3100	/* Size of the pool used besides the stream input buffer (tables and MCU buffers, worst case) */
+#define JD_FORMAT		0	/* Default output pixel format 0:RGB888 (3 BYTE/pix), 1:RGB565 (1 WORD/pix), 2:RGB565 byte swapped (2 BYTE/pix) */
 #define	JD_USE_SCALE	1	/* Use descaling feature for output */
-#define JD_TBLCLIP		0	/* Use table for saturation (might be a bit faster but increases 1K bytes of code size) */
+#define JD_TBLCLIP		1	/* Compile in the table for saturation (selected by lgfxJdec::tblclip at run time, increases 1K bytes of code size) */
 #define JD_BAYER		1	/* Use bayer pattern table */
 
 /*---------------------------------------------------------------------------*/
@@ -78,9 +79,13 @@ struct lgfxJdec {
 	uint8_t* mcubuf;			/* Working buffer for the MCU */
 	uint8_t* pool;				/* Pointer to available memory pool */
 	uint_fast16_t sz_pool;			/* Size of momory pool (bytes available) */
+	uint_fast16_t sz_buf;		/* Size of stream input buffer */
+	uint8_t format;				/* Output pixel format (see JD_FORMAT, can be changed before lgfx_jd_decomp) */
+	uint8_t tblclip;			/* 1=Use table for saturation (can be changed before lgfx_jd_decomp) */
 	uint32_t (*infunc)(lgfxJdec*, uint8_t*, uint32_t);/* Pointer to jpeg stream input function */
 	void* device;				/* Pointer to I/O device identifiler for the session */
 	uint8_t comps_in_frame;		/* 1=Y(grayscale)  3=YCrCb */
+	uint32_t data_ofs;			/* Offset of the entropy coded data in the stream */
 };
 
 
@@ -88,6 +93,8 @@ struct lgfxJdec {
 /* TJpgDec API functions */
 JRESULT lgfx_jd_prepare (lgfxJdec*, uint32_t(*)(lgfxJdec*,uint8_t*,uint32_t), void*, uint_fast16_t, void*);
 JRESULT lgfx_jd_decomp (lgfxJdec*, uint32_t(*)(lgfxJdec*,void*,JRECT*), uint_fast8_t);
+JRESULT lgfx_jd_share (lgfxJdec*, const lgfxJdec*, uint32_t(*)(lgfxJdec*,uint8_t*,uint32_t), void*, uint_fast16_t, void*);
+JRESULT lgfx_jd_decomp_rows (lgfxJdec*, uint32_t(*)(lgfxJdec*,void*,JRECT*), uint_fast8_t, uint32_t, uint32_t);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,168 @@
+#!/usr/bin/env python3
+"""BDF -> lgfx::AAfont converter.
+
+Converts a BDF font into the anti-aliased font format of LovyanGFX
+(lgfx::AAfont : 2bpp / 4bpp coverage, per-glyph RLE) and writes a C++ header.
+
+Anti-aliasing is done by supersampling: rasterize the source at N times the
+target size and pass -s N. Each N x N block of source pixels becomes one
+output pixel whose coverage is quantized to 4 (2bpp) or 16 (4bpp) levels.
+
+TTF / OTF sources are rasterized with otf2bdf first (see Fonts/IPA/README.md):
+
+  ./otf2bdf -r 72 -p 160 -o ipag_160.bdf ipag.ttf
+  python3 bdf2aafont.py -s 4 -b 4 -r 0x20-0x7E -n lgfx_font_digits_40 ipag_160.bdf > lgfx_font_digits_40.h
+
+RLE data : 1 byte = (run length - 1) << bpp | level
+           runs are taken in raster order over width * height pixels.
+"""
+
+import argparse
+import sys
+
+
+def parse_bdf(path):
+    glyphs = []
+    ascent = descent = None
+    with open(path, 'r', encoding='latin-1') as f:
+        lines = iter(f.read().splitlines())
+    for line in lines:
+        tok = line.split()
+        if not tok:
+            continue
+        if tok[0] == 'FONT_ASCENT':
+            ascent = int(tok[1])
+        elif tok[0] == 'FONT_DESCENT':
+            descent = int(tok[1])
+        elif tok[0] == 'STARTCHAR':
+            g = {'encoding': -1, 'dwidth': 0, 'bbx': (0, 0, 0, 0), 'rows': []}
+            for line in lines:
+                tok = line.split()
+                if not tok:
+                    continue
+                if tok[0] == 'ENCODING':
+                    g['encoding'] = int(tok[-1])
+                elif tok[0] == 'DWIDTH':
+                    g['dwidth'] = int(tok[1])
+                elif tok[0] == 'BBX':
+                    g['bbx'] = tuple(int(v) for v in tok[1:5])
+                elif tok[0] == 'BITMAP':
+                    for line in lines:
+                        if line.startswith('ENDCHAR'):
+                            break
+                        hexrow = line.strip() or '00'
+                        g['rows'].append((int(hexrow, 16), len(hexrow) * 4))
+                    break
+            glyphs.append(g)
+    if ascent is None or descent is None:
+        raise SystemExit('FONT_ASCENT / FONT_DESCENT not found')
+    return ascent, descent, glyphs
+
+
+def ceil_div(a, b):
+    return -(-a // b)
+
+
+def convert_glyph(g, scale, maxlevel):
+    bw, bh, bx, by = g['bbx']
+    # cover[(cy, cx)] : count of set source pixels, cy counted upward from baseline
+    cover = {}
+    for r, (bits, rowbits) in enumerate(g['rows'][:bh]):
+        y_up = by + bh - 1 - r
+        for c in range(bw):
+            if bits >> (rowbits - 1 - c) & 1:
+                key = ((y_up // scale), ((bx + c) // scale))
+                cover[key] = cover.get(key, 0) + 1
+    xadv = int(round(g['dwidth'] / scale))
+    if not cover:
+        return dict(width=0, height=0, xAdvance=xadv, xOffset=0, yOffset=0, levels=[])
+    cys = [k[0] for k in cover]
+    cxs = [k[1] for k in cover]
+    top, bottom = max(cys), min(cys)
+    x0, x1 = min(cxs), max(cxs)
+    area = scale * scale
+    levels = []
+    for cy in range(top, bottom - 1, -1):
+        for cx in range(x0, x1 + 1):
+            levels.append((cover.get((cy, cx), 0) * maxlevel + area // 2) // area)
+    return dict(width=x1 - x0 + 1, height=top - bottom + 1, xAdvance=xadv,
+                xOffset=x0, yOffset=-(top + 1), levels=levels)
+
+
+def rle(levels, bpp):
+    out = []
+    maxrun = 1 << (8 - bpp)
+    i = 0
+    while i < len(levels):
+        v = levels[i]
+        run = 1
+        while i + run < len(levels) and levels[i + run] == v and run < maxrun:
+            run += 1
+        out.append((run - 1) << bpp | v)
+        i += run
+    return out
+
+
+def parse_ranges(specs):
+    codes = set()
+    for spec in specs:
+        for part in spec.split(','):
+            if '-' in part:
+                a, b = part.split('-')
+                codes.update(range(int(a, 0), int(b, 0) + 1))
+            elif part:
+                codes.add(int(part, 0))
+    return codes
+
+
+def main():
+    ap = argparse.ArgumentParser(description='BDF to lgfx::AAfont converter')
+    ap.add_argument('bdf')
+    ap.add_argument('-n', '--name', required=True, help='C identifier of the font')
+    ap.add_argument('-b', '--bpp', type=int, choices=(2, 4), default=4)
+    ap.add_argument('-s', '--scale', type=int, default=1, help='supersampling factor of the source')
+    ap.add_argument('-r', '--range', action='append', default=[], help='code range. e.g. 0x20-0x7E,0x3000')
+    ap.add_argument('-c', '--chars', default='', help='characters to include (UTF-8)')
+    args = ap.parse_args()
+
+    ascent, descent, glyphs = parse_bdf(args.bdf)
+    wanted = parse_ranges(args.range) | set(ord(ch) for ch in args.chars)
+    maxlevel = (1 << args.bpp) - 1
+
+    glyphs = [g for g in glyphs if 0 <= g['encoding'] <= 0xFFFF and (not wanted or g['encoding'] in wanted)]
+    glyphs.sort(key=lambda g: g['encoding'])
+    if not glyphs:
+        raise SystemExit('no glyph selected')
+
+    name = args.name
+    bitmap = []
+    entries = []
+    for g in glyphs:
+        c = convert_glyph(g, args.scale, maxlevel)
+        entries.append((len(bitmap), g['encoding'], c))
+        bitmap += rle(c['levels'], args.bpp)
+
+    asc = ceil_div(ascent, args.scale)
+    desc = ceil_div(descent, args.scale)
+
+    w = sys.stdout.write
+    w('// Generated by bdf2aafont.py : %s (%dbpp, x%d supersampling)\n\n' % (args.bdf.split('/')[-1], args.bpp, args.scale))
+    w('#ifndef PROGMEM\n#define PROGMEM\n#endif\n\n')
+    w('constexpr std::uint8_t %sBitmaps[] PROGMEM = {\n' % name)
+    for i in range(0, len(bitmap), 12):
+        w('  ' + ', '.join('0x%02X' % v for v in bitmap[i:i + 12]) + ',\n')
+    w('  0x00 };\n\n')
+    w('constexpr lgfx::AAglyph %sGlyphs[] PROGMEM = {\n' % name)
+    for ofs, code, c in entries:
+        ch = chr(code) if 0x20 < code < 0x7F and chr(code) not in '\\\'' else ''
+        w('  { %6d, 0x%04X, %3d, %3d, %3d, %4d, %4d },  // %s\n' % (
+            ofs, code, c['width'], c['height'], c['xAdvance'], c['xOffset'], c['yOffset'],
+            ("0x%04X '%s'" % (code, ch)) if ch else '0x%04X' % code))
+    w('};\n\n')
+    w('constexpr lgfx::AAfont %s PROGMEM = {\n' % name)
+    w('  %sBitmaps,\n  %sGlyphs,\n  %d, %d, %d, %d, %d };\n\n' % (name, name, len(entries), args.bpp, asc + desc, asc, desc))
+    w('// Approx. %d bytes\n' % (len(bitmap) + 12 * len(entries) + 16))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,189 @@
+/*
+  TJpgDec decode profile benchmark (host)
+
+  build:
+    cc -O2 -o jpgbench tools/jpgbench.c src/lgfx/utility/lgfx_tjpgd.c
+
+  usage:
+    ./jpgbench [-n repeat] [-s scale(0-3)] file.jpg ...
+
+  Each file is decoded into a 16bpp frame buffer (swap565, as the panel receives it)
+  with every decode profile, and pixels/s is reported per profile.
+  The RGB888 profiles include the conversion to swap565 that draw_jpg performs.
+  "diff" counts pixels that differ from the default profile.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../src/lgfx/utility/lgfx_tjpgd.h"
+
+typedef struct {
+  const uint8_t* src;
+  size_t len;
+  size_t pos;
+  uint32_t reads;   /* Number of input function calls */
+  uint8_t* fb;      /* swap565 frame buffer */
+  uint32_t fb_w;
+} bench_io_t;
+
+typedef struct {
+  const char* name;
+  uint8_t format;   /* 0:RGB888 2:swap565 */
+  uint8_t tblclip;
+  uint16_t sz_pool;
+} profile_t;
+
+static const profile_t profiles[] = {
+  { "default"         , 0, 0, 3100 },
+  { "tblclip"         , 0, 1, 3100 },
+  { "swap565"         , 2, 0, 3100 },
+  { "fast"            , 2, 1, 3100 },
+  { "large_pool"      , 0, 0, JD_SZWORK + JD_SZBUF * 8 },
+  { "fast+large_pool" , 2, 1, JD_SZWORK + JD_SZBUF * 8 },
+};
+#define PROFILE_COUNT (sizeof(profiles) / sizeof(profiles[0]))
+
+static uint32_t in_func(lgfxJdec* jd, uint8_t* buf, uint32_t len)
+{
+  bench_io_t* io = (bench_io_t*)jd->device;
+  ++io->reads;
+  if (len > io->len - io->pos) len = io->len - io->pos;
+  if (buf) memcpy(buf, io->src + io->pos, len);
+  io->pos += len;
+  return len;
+}
+
+static uint32_t out_func(lgfxJdec* jd, void* bitmap, JRECT* rect)
+{
+  bench_io_t* io = (bench_io_t*)jd->device;
+  uint32_t w = rect->right - rect->left + 1;
+  uint8_t* src = (uint8_t*)bitmap;
+  for (uint32_t y = rect->top; y <= rect->bottom; ++y) {
+    uint8_t* dst = &io->fb[(y * io->fb_w + rect->left) * 2];
+    if (jd->format == 2) {
+      memcpy(dst, src, w * 2);
+      src += w * 2;
+    } else {
+      for (uint32_t x = 0; x < w; ++x) {  /* bgr888 -> swap565 */
+        dst[0] = (src[0] & 0xF8) | (src[1] >> 5);
+        dst[1] = ((src[1] << 3) & 0xE0) | (src[2] >> 3);
+        dst += 2;
+        src += 3;
+      }
+    }
+  }
+  return 1;
+}
+
+static double now_sec(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static uint8_t* load_file(const char* path, size_t* len)
+{
+  FILE* fp = fopen(path, "rb");
+  if (!fp) return NULL;
+  fseek(fp, 0, SEEK_END);
+  *len = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  uint8_t* buf = (uint8_t*)malloc(*len);
+  if (buf && fread(buf, 1, *len, fp) != *len) { free(buf); buf = NULL; }
+  fclose(fp);
+  return buf;
+}
+
+/* Decode one image with a profile. returns JDR_OK and the decoded size */
+static JRESULT decode(const profile_t* prof, bench_io_t* io, uint8_t scale, uint8_t* pool, uint32_t* w, uint32_t* h)
+{
+  lgfxJdec jd;
+  io->pos = 0;
+  JRESULT res = lgfx_jd_prepare(&jd, in_func, pool, prof->sz_pool, io);
+  if (res != JDR_OK) return res;
+  jd.format = prof->format;
+  jd.tblclip = prof->tblclip;
+  *w = (jd.width + (1 << scale) - 1) >> scale;
+  *h = (jd.height + (1 << scale) - 1) >> scale;
+  if (!io->fb) {
+    io->fb_w = *w;
+    io->fb = (uint8_t*)calloc(*w * *h, 2);
+  }
+  return lgfx_jd_decomp(&jd, out_func, scale);
+}
+
+int main(int argc, char* argv[])
+{
+  int repeat = 20;
+  uint8_t scale = 0;
+  int first = 1;
+  for (; first < argc && argv[first][0] == '-'; first += 2) {
+    if (first + 1 >= argc) break;
+    if (argv[first][1] == 'n') repeat = atoi(argv[first + 1]);
+    if (argv[first][1] == 's') scale = atoi(argv[first + 1]);
+  }
+  if (first >= argc || repeat < 1 || scale > 3) {
+    fprintf(stderr, "usage: %s [-n repeat] [-s scale(0-3)] file.jpg ...\n", argv[0]);
+    return 1;
+  }
+
+  uint8_t* pool = (uint8_t*)malloc(JD_SZWORK + JD_SZBUF * 8);
+  double total_sec[PROFILE_COUNT] = { 0 };
+  double total_pix[PROFILE_COUNT] = { 0 };
+  uint32_t total_diff[PROFILE_COUNT] = { 0 };
+  uint32_t total_fail[PROFILE_COUNT] = { 0 };
+  uint32_t total_reads[PROFILE_COUNT] = { 0 };
+
+  for (int f = first; f < argc; ++f) {
+    size_t len;
+    uint8_t* data = load_file(argv[f], &len);
+    if (!data) { fprintf(stderr, "%s: read error\n", argv[f]); continue; }
+
+    uint8_t* ref = NULL;
+    size_t ref_len = 0;
+    for (size_t p = 0; p < PROFILE_COUNT; ++p) {
+      bench_io_t io = { data, len, 0, 0, NULL, 0 };
+      uint32_t w = 0, h = 0;
+      JRESULT res = decode(&profiles[p], &io, scale, pool, &w, &h);
+      if (res != JDR_OK) {
+        printf("%-20s %-16s error %d\n", argv[f], profiles[p].name, res);
+        ++total_fail[p];
+        free(io.fb);
+        continue;
+      }
+      total_reads[p] += io.reads;
+      if (p == 0) {
+        ref = io.fb;
+        ref_len = (size_t)w * h * 2;
+        io.fb = NULL;
+      } else if (ref) {
+        for (size_t i = 0; i < ref_len; i += 2) {
+          if (ref[i] != io.fb[i] || ref[i + 1] != io.fb[i + 1]) ++total_diff[p];
+        }
+      }
+
+      double t = now_sec();
+      for (int r = 0; r < repeat; ++r) {
+        decode(&profiles[p], &io, scale, pool, &w, &h);
+      }
+      total_sec[p] += now_sec() - t;
+      total_pix[p] += (double)w * h * repeat;
+      free(io.fb);
+    }
+    free(ref);
+    free(data);
+  }
+
+  printf("%-16s %14s %10s %8s %8s %6s\n", "profile", "pixels/s", "ratio", "reads", "diff", "fail");
+  for (size_t p = 0; p < PROFILE_COUNT; ++p) {
+    double pps = total_sec[p] > 0 ? total_pix[p] / total_sec[p] : 0;
+    double base = total_sec[0] > 0 ? total_pix[0] / total_sec[0] : 0;
+    printf("%-16s %14.0f %10.3f %8u %8u %6u\n", profiles[p].name, pps, base > 0 ? pps / base : 0
+          , total_reads[p], total_diff[p], total_fail[p]);
+  }
+  free(pool);
+  return 0;
+}
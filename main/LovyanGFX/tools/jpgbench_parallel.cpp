@@ -0,0 +1,175 @@
+/*
+  Parallel JPEG decode benchmark (host, std::thread)
+
+  build:
+    cc -O2 -c -o lgfx_tjpgd.o src/lgfx/utility/lgfx_tjpgd.c
+    c++ -std=c++11 -O2 -pthread -o jpgbench_parallel tools/jpgbench_parallel.cpp lgfx_tjpgd.o
+
+  usage:
+    ./jpgbench_parallel [-n repeat] [-s scale(0-3)] file.jpg ...
+
+  Each file is decoded into a swap565 frame buffer serially (lgfx_jd_decomp)
+  and with jpg_parallel_t (two workers splitting at restart intervals),
+  and pixels/s is reported for both. Files without restart markers (DRI)
+  are reported as "serial only". "diff" counts pixels that differ.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+namespace lgfx
+{
+  static inline void* heap_alloc(     size_t length) { return malloc(length); }
+  static inline void* heap_alloc_dma( size_t length) { return malloc(length); }
+  static inline void heap_free(void* buf) { free(buf); }
+}
+
+#include "../src/lgfx/utility/lgfx_jpg_parallel.hpp"
+
+struct bench_t
+{
+  const std::uint8_t* src;
+  std::uint32_t len;
+  std::uint32_t pos;
+  std::vector<std::uint8_t> fb;   // swap565
+  std::uint32_t fb_w;
+};
+
+static std::uint32_t in_func(lgfxJdec* jd, std::uint8_t* buf, std::uint32_t len)
+{
+  auto b = static_cast<bench_t*>(jd->device);
+  if (len > b->len - b->pos) len = b->len - b->pos;
+  if (buf) memcpy(buf, b->src + b->pos, len);
+  b->pos += len;
+  return len;
+}
+
+// RGB888 -> swap565
+static void convert_rows(const std::uint8_t* src, std::uint32_t w, std::uint32_t h, std::uint8_t* dst, std::uint32_t stride)
+{
+  for (std::uint32_t y = 0; y < h; ++y) {
+    auto d = dst + y * stride * 2;
+    for (std::uint32_t x = 0; x < w; ++x) {
+      d[0] = (src[0] & 0xF8) | (src[1] >> 5);
+      d[1] = ((src[1] << 3) & 0xE0) | (src[2] >> 3);
+      d += 2;
+      src += 3;
+    }
+  }
+}
+
+static std::uint32_t out_func(lgfxJdec* jd, void* bitmap, JRECT* rect)
+{
+  auto b = static_cast<bench_t*>(jd->device);
+  convert_rows(static_cast<std::uint8_t*>(bitmap), rect->right - rect->left + 1, rect->bottom - rect->top + 1
+              , &b->fb[(rect->top * b->fb_w + rect->left) * 2], b->fb_w);
+  return 1;
+}
+
+static void parallel_convert(void*, int, void* bitmap, const JRECT* rect, std::uint8_t* dst, std::int32_t stride)
+{
+  convert_rows(static_cast<std::uint8_t*>(bitmap), rect->right - rect->left + 1, rect->bottom - rect->top + 1, dst, stride);
+}
+
+static bool parallel_output(void* param, std::uint8_t* band, std::int32_t y, std::int32_t w, std::int32_t h)
+{
+  auto b = static_cast<bench_t*>(param);
+  memcpy(&b->fb[y * b->fb_w * 2], band, w * h * 2);
+  return true;
+}
+
+static std::uint8_t pool[JD_SZWORK + JD_SZBUF];
+
+static JRESULT prepare(lgfxJdec* jd, bench_t* b, std::uint_fast8_t scale)
+{
+  b->pos = 0;
+  JRESULT res = lgfx_jd_prepare(jd, in_func, pool, sizeof(pool), b);
+  if (res != JDR_OK) return res;
+  if (b->fb.empty()) {
+    b->fb_w = jd->width >> scale;
+    b->fb.resize(b->fb_w * (jd->height >> scale) * 2 + 64);
+  }
+  return JDR_OK;
+}
+
+static JRESULT decode_serial(bench_t* b, std::uint_fast8_t scale)
+{
+  lgfxJdec jd;
+  JRESULT res = prepare(&jd, b, scale);
+  return res != JDR_OK ? res : lgfx_jd_decomp(&jd, out_func, scale);
+}
+
+// returns JDR_PAR if the image cannot be split
+static JRESULT decode_parallel(bench_t* b, std::uint_fast8_t scale)
+{
+  lgfxJdec jd;
+  JRESULT res = prepare(&jd, b, scale);
+  if (res != JDR_OK) return res;
+  lgfx::jpg_parallel_t parallel;
+  if (!parallel.setup(&jd, b->src, b->len, scale, 2)) return JDR_PAR;
+  return parallel.decode(parallel_convert, parallel_output, b);
+}
+
+static double now_sec(void)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char* argv[])
+{
+  int repeat = 20;
+  std::uint_fast8_t scale = 0;
+  int first = 1;
+  for (; first + 1 < argc && argv[first][0] == '-'; first += 2) {
+    if (argv[first][1] == 'n') repeat = atoi(argv[first + 1]);
+    if (argv[first][1] == 's') scale = atoi(argv[first + 1]);
+  }
+  if (first >= argc || repeat < 1 || scale > 3) {
+    fprintf(stderr, "usage: %s [-n repeat] [-s scale(0-3)] file.jpg ...\n", argv[0]);
+    return 1;
+  }
+
+  printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+  printf("%-32s %14s %14s %8s %8s\n", "file", "serial px/s", "parallel px/s", "ratio", "diff");
+  double total_serial = 0, total_parallel = 0, total_pix = 0;
+  for (int f = first; f < argc; ++f) {
+    FILE* fp = fopen(argv[f], "rb");
+    if (!fp) { fprintf(stderr, "%s: read error\n", argv[f]); continue; }
+    std::vector<std::uint8_t> data;
+    fseek(fp, 0, SEEK_END);
+    data.resize(ftell(fp));
+    fseek(fp, 0, SEEK_SET);
+    if (fread(data.data(), 1, data.size(), fp) != data.size()) data.clear();
+    fclose(fp);
+
+    bench_t ser = { data.data(), (std::uint32_t)data.size(), 0, {}, 0 };
+    bench_t par = ser;
+    JRESULT res = decode_serial(&ser, scale);
+    if (res != JDR_OK) { printf("%-32s error %d\n", argv[f], res); continue; }
+    res = decode_parallel(&par, scale);
+    if (res == JDR_PAR) { printf("%-32s serial only\n", argv[f]); continue; }
+    if (res != JDR_OK) { printf("%-32s parallel error %d\n", argv[f], res); continue; }
+
+    std::uint32_t diff = 0;
+    for (std::size_t i = 0; i + 1 < ser.fb.size(); i += 2) {
+      if (ser.fb[i] != par.fb[i] || ser.fb[i + 1] != par.fb[i + 1]) ++diff;
+    }
+
+    double pix = (double)ser.fb_w * (ser.fb.size() - 64) / 2 / ser.fb_w * repeat;
+    double t = now_sec();
+    for (int r = 0; r < repeat; ++r) decode_serial(&ser, scale);
+    double ts = now_sec() - t;
+    t = now_sec();
+    for (int r = 0; r < repeat; ++r) decode_parallel(&par, scale);
+    double tp = now_sec() - t;
+    total_serial += ts;
+    total_parallel += tp;
+    total_pix += pix;
+    printf("%-32s %14.0f %14.0f %8.3f %8u\n", argv[f], pix / ts, pix / tp, ts / tp, diff);
+  }
+  if (total_pix > 0) {
+    printf("%-32s %14.0f %14.0f %8.3f\n", "total", total_pix / total_serial, total_pix / total_parallel, total_serial / total_parallel);
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""Asset partition packer.
+
+Packs image and font files into one partition image. PartitionWrapper maps
+it with esp_partition_mmap (on the host, mmap of the image file), so
+drawJpg / drawPng / drawBmp / loadFont read the assets in place without
+going through VFS. Asset names are the file names (at most 23 bytes).
+
+With -p the partition size is taken from the partitions.csv row named by -l
+(default "assets"); the image is padded to that size and it is an error if
+the assets do not fit.
+
+layout (little endian):
+
+  0 : "LGFA"
+  4 : asset count
+  8 : count x { char name[24]; uint32 offset; uint32 size; }
+      asset data, each aligned to 4 bytes
+
+usage:
+  python3 lgfx_asset_pack.py -p partitions.csv -o assets.bin logo.png gauge.jpg font.vlw
+  esptool.py write_flash 0x320000 assets.bin    (offset of the partition)
+"""
+import argparse
+import os
+import struct
+import sys
+
+ENTRY_SIZE = 32
+NAME_SIZE = 24
+
+
+def parse_size(text):
+    text = text.strip()
+    if not text:
+        return None
+    unit = 1
+    if text[-1] in 'kK':
+        unit, text = 1024, text[:-1]
+    elif text[-1] in 'mM':
+        unit, text = 1024 * 1024, text[:-1]
+    return int(text, 0) * unit
+
+
+def partition_size(csv_path, label):
+    with open(csv_path) as f:
+        for line in f:
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            cols = [c.strip() for c in line.split(',')]
+            if cols[0] == label and len(cols) >= 5:
+                return parse_size(cols[4])
+    return None
+
+
+def pack(files):
+    names = []
+    for path in files:
+        name = os.path.basename(path).encode('utf-8')
+        if len(name) >= NAME_SIZE:
+            sys.exit('%s: name too long (max %d bytes)' % (path, NAME_SIZE - 1))
+        if name in names:
+            sys.exit('%s: duplicate name' % path)
+        names.append(name)
+
+    offset = 8 + ENTRY_SIZE * len(files)
+    table = b''
+    body = b''
+    for name, path in zip(names, files):
+        with open(path, 'rb') as f:
+            data = f.read()
+        pad = (-(offset + len(body))) & 3
+        body += b'\0' * pad
+        table += struct.pack('<24sII', name, offset + len(body), len(data))
+        body += data
+    return b'LGFA' + struct.pack('<I', len(files)) + table + body
+
+
+def main():
+    parser = argparse.ArgumentParser(description='pack assets into a partition image')
+    parser.add_argument('-o', '--output', required=True)
+    parser.add_argument('-p', '--partitions', help='partitions.csv to take the size from')
+    parser.add_argument('-l', '--label', default='assets', help='partition name in partitions.csv')
+    parser.add_argument('files', nargs='+')
+    args = parser.parse_args()
+
+    image = pack(args.files)
+    if args.partitions:
+        size = partition_size(args.partitions, args.label)
+        if size is None:
+            sys.exit('%s: partition "%s" not found' % (args.partitions, args.label))
+        if len(image) > size:
+            sys.exit('assets: %d bytes do not fit in "%s" (%d bytes)' % (len(image), args.label, size))
+        image += b'\xff' * (size - len(image))
+
+    with open(args.output, 'wb') as f:
+        f.write(image)
+    print('%s: %d assets, %d bytes' % (args.output, len(args.files), len(image)))
+
+
+if __name__ == '__main__':
+    main()
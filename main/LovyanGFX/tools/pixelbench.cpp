@@ -0,0 +1,146 @@
+/*
+  Fill / convert kernel benchmark (host)
+
+  build:
+    c++ -std=c++11 -O2 -o pixelbench tools/pixelbench.cpp                  (SSE2 / NEON)
+    c++ -std=c++11 -O2 -mssse3 -o pixelbench tools/pixelbench.cpp          (+ SSSE3 24bpp convert)
+    c++ -std=c++11 -O2 -DLGFX_NO_SIMD -o pixelbench tools/pixelbench.cpp   (word-wide kernels only)
+
+  usage:
+    ./pixelbench [-n repeat] [-w width]
+
+  Each kernel runs on a row of <width> pixels (default 320) <repeat> times.
+  "old" is the per-pixel code the library used before (memset_multi seeding
+  with 16bit writes, normalcopy converting one pixel per step), "new" is the
+  current fill_16bit / pixelcopy_t::copy_rgb_fast. Mpx/s is reported for both;
+  "diff" counts output pixels that differ. Rows start at an odd pixel offset
+  as well to cover the unaligned head/tail handling.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include "../src/lgfx/lgfx_common.hpp"
+
+using namespace lgfx;
+
+// 以前の memset_multi (2byte)
+static void old_fill(std::uint8_t* buf, std::uint32_t c, std::size_t length)
+{
+  std::size_t l = length;
+  if (l & ~0xF) {
+    while ((l >>= 1) & ~0xF);
+    ++l;
+  }
+  std::size_t len = l * 2;
+  length = (length * 2) - len;
+  std::uint8_t* dst = buf;
+  do {
+    *(std::uint16_t*)dst = c;
+    dst += 2;
+  } while (--l);
+  if (!length) return;
+  while (length > len) {
+    memcpy(dst, buf, len);
+    dst += len;
+    length -= len;
+    len <<= 1;
+  }
+  memcpy(dst, buf, length);
+}
+
+// 以前の normalcopy (1画素ずつ変換)
+template <typename TDst, typename TSrc>
+static void old_copy(TDst* d, const TSrc* s, std::int32_t len)
+{
+  std::uint32_t src_x32 = 0;
+  std::int32_t index = 0;
+  do {
+    d[index] = s[src_x32 >> FP_SCALE];
+    src_x32 += 1 << FP_SCALE;
+  } while (++index != len);
+}
+
+static double now_sec(void)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int repeat = 20000;
+static int width = 320;
+
+static void report(const char* name, double t_old, double t_new, std::uint32_t diff)
+{
+  double pix = (double)width * repeat;
+  printf("%-22s %10.1f %10.1f %8.2f %6u\n", name, pix / t_old / 1e6, pix / t_new / 1e6, t_old / t_new, diff);
+}
+
+template <typename TSrc>
+static void bench_convert(const char* name, std::int32_t offset)
+{
+  std::vector<TSrc> src(width + 1);
+  auto p = (std::uint8_t*)src.data();
+  for (std::size_t i = 0; i < src.size() * sizeof(TSrc); ++i) p[i] = rand();
+  std::vector<swap565_t> d_old(width + 1), d_new(width + 1);
+
+  double t = now_sec();
+  for (int r = 0; r < repeat; ++r) old_copy(&d_old[offset], &src[offset], width);
+  double t_old = now_sec() - t;
+  t = now_sec();
+  for (int r = 0; r < repeat; ++r) pixelcopy_t::copy_rgb_fast(&d_new[offset], &src[offset], width);
+  double t_new = now_sec() - t;
+
+  std::uint32_t diff = 0;
+  for (int i = 0; i < width; ++i) diff += d_old[offset + i].raw != d_new[offset + i].raw;
+  report(name, t_old, t_new, diff);
+}
+
+static void bench_fill(const char* name, std::int32_t offset)
+{
+  std::vector<std::uint16_t> d_old(width + 1), d_new(width + 1);
+  std::uint32_t c = 0x1234;
+
+  double t = now_sec();
+  for (int r = 0; r < repeat; ++r) old_fill((std::uint8_t*)&d_old[offset], c, width);
+  double t_old = now_sec() - t;
+  t = now_sec();
+  for (int r = 0; r < repeat; ++r) fill_16bit(&d_new[offset], c, width);
+  double t_new = now_sec() - t;
+
+  std::uint32_t diff = 0;
+  for (int i = 0; i < width; ++i) diff += d_old[offset + i] != d_new[offset + i];
+  report(name, t_old, t_new, diff);
+}
+
+int main(int argc, char* argv[])
+{
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (argv[i][1] == 'n') repeat = atoi(argv[i + 1]);
+    if (argv[i][1] == 'w') width = atoi(argv[i + 1]);
+  }
+  if (repeat < 1 || width < 1) {
+    fprintf(stderr, "usage: %s [-n repeat] [-w width]\n", argv[0]);
+    return 1;
+  }
+
+#if defined (LGFX_SIMD_SSSE3)
+  const char* simd = "SSE2 + SSSE3";
+#elif defined (LGFX_SIMD_SSE2)
+  const char* simd = "SSE2";
+#elif defined (LGFX_SIMD_NEON)
+  const char* simd = "NEON";
+#else
+  const char* simd = "none";
+#endif
+  printf("simd: %s  width: %d  repeat: %d\n", simd, width, repeat);
+  printf("%-22s %10s %10s %8s %6s\n", "kernel", "old Mpx/s", "new Mpx/s", "ratio", "diff");
+  for (std::int32_t offset = 0; offset < 2; ++offset) {
+    bench_fill(offset ? "fill16 (odd)" : "fill16", offset);
+    bench_convert<rgb565_t>(offset ? "rgb565->swap565 (odd)" : "rgb565->swap565", offset);
+    bench_convert<bgr888_t>(offset ? "bgr888->swap565 (odd)" : "bgr888->swap565", offset);
+    bench_convert<rgb888_t>(offset ? "rgb888->swap565 (odd)" : "rgb888->swap565", offset);
+    bench_convert<rgb332_t>(offset ? "rgb332->swap565 (odd)" : "rgb332->swap565", offset);
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+/*
+  U8g2 glyph lookup benchmark (host)
+
+  build:
+    cc -O2 -c -o lgfx_font_japan.o src/Fonts/IPA/lgfx_font_japan.c
+    c++ -std=c++11 -O2 -pthread -o u8g2bench tools/u8g2bench.cpp lgfx_font_japan.o
+
+  usage:
+    ./u8g2bench [-n repeat]
+
+  For each IPA font, U8g2font::updateFontMetric is timed over ASCII (0x20-0x7E)
+  and over every CJK code point (0x3000-0x9FFF), once with the lazy glyph index
+  and once with the linear chain walk (index allocation forced to fail).
+  "diff" counts code points (0x0000-0xFFFF) whose metrics differ between the
+  two paths. The index build itself is also timed from several threads at
+  once ("race") to check that all of them end up on the same published index.
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace lgfx
+{
+  static bool fail_alloc = false;
+  static inline void* heap_alloc(      size_t length) { return fail_alloc ? nullptr : malloc(length); }
+  static inline void* heap_alloc_dma(  size_t length) { return malloc(length); }
+  static inline void* heap_alloc_psram(size_t length) { return malloc(length); }
+  static inline void heap_free(void* buf) { free(buf); }
+}
+
+#include "../src/Fonts/lgfx_fonts.cpp"
+
+// 描画系はベンチマークでは使用しないため空の定義でリンクを通す
+namespace lgfx
+{
+  void LGFXBase::writeFillRect(std::int32_t, std::int32_t, std::int32_t, std::int32_t) {}
+  void LGFXBase::fillRect(std::int32_t, std::int32_t, std::int32_t, std::int32_t) {}
+  void LGFXBase::getClipRect(std::int32_t*, std::int32_t*, std::int32_t*, std::int32_t*) {}
+  void LGFXBase::pushImage(std::int32_t, std::int32_t, std::int32_t, std::int32_t, pixelcopy_t*, bool) {}
+  void LGFXBase::read_rect(std::int32_t, std::int32_t, std::int32_t, std::int32_t, void*, pixelcopy_t*) {}
+}
+
+using namespace lgfx;
+
+static double now_sec(void)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int repeat = 20;
+
+static void use_linear(const U8g2font* font, bool linear)
+{
+  font->releaseGlyphIndex();
+  fail_alloc = linear;
+  FontMetrics m;
+  font->updateFontMetric(&m, ' ');  // インデックスの作成 (または作成失敗) をここで済ませる
+  fail_alloc = false;
+}
+
+static double bench(const U8g2font* font, const std::vector<std::uint16_t>& codes)
+{
+  FontMetrics m;
+  volatile std::int32_t sink = 0;
+  double t = now_sec();
+  for (int r = 0; r < repeat; ++r) {
+    for (auto c : codes) {
+      if (font->updateFontMetric(&m, c)) sink += m.x_advance;
+    }
+  }
+  (void)sink;
+  return (now_sec() - t) * 1e9 / ((double)repeat * codes.size());
+}
+
+static std::uint32_t compare(const U8g2font* font)
+{
+  static FontMetrics linear[0x10000];
+  static bool found[0x10000];
+  use_linear(font, true);
+  for (std::uint32_t c = 0; c < 0x10000; ++c) {
+    memset(&linear[c], 0, sizeof(FontMetrics));
+    found[c] = font->updateFontMetric(&linear[c], c);
+  }
+  use_linear(font, false);
+  std::uint32_t diff = 0;
+  for (std::uint32_t c = 0; c < 0x10000; ++c) {
+    FontMetrics m;
+    memset(&m, 0, sizeof(FontMetrics));
+    bool f = font->updateFontMetric(&m, c);
+    if (f != found[c] || (f && (m.width != linear[c].width || m.x_offset != linear[c].x_offset || m.x_advance != linear[c].x_advance))) ++diff;
+  }
+  return diff;
+}
+
+// 複数スレッドから同時に初回検索を行い、全員が同じ結果を得ることを確認する
+static bool race(const U8g2font* font)
+{
+  static constexpr int threads = 4;
+  bool ok = true;
+  for (int r = 0; r < 100 && ok; ++r) {
+    font->releaseGlyphIndex();
+    FontMetrics m[threads];
+    bool res[threads];
+    std::vector<std::thread> th;
+    for (int i = 0; i < threads; ++i) {
+      th.emplace_back([=, &m, &res] { res[i] = font->updateFontMetric(&m[i], 0x3042); });
+    }
+    for (auto& t : th) t.join();
+    for (int i = 1; i < threads; ++i) {
+      if (res[i] != res[0] || m[i].x_advance != m[0].x_advance || m[i].width != m[0].width) ok = false;
+    }
+  }
+  return ok;
+}
+
+int main(int argc, char* argv[])
+{
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (argv[i][1] == 'n') repeat = atoi(argv[i + 1]);
+  }
+  if (repeat < 1) {
+    fprintf(stderr, "usage: %s [-n repeat]\n", argv[0]);
+    return 1;
+  }
+
+  static const struct { const char* name; const U8g2font* font; } fonts[] =
+  { { "lgfxJapanGothic_16" , &fonts::lgfxJapanGothic_16  }
+  , { "lgfxJapanGothicP_24", &fonts::lgfxJapanGothicP_24 }
+  , { "lgfxJapanMincho_40" , &fonts::lgfxJapanMincho_40  }
+  };
+
+  std::vector<std::uint16_t> ascii, cjk;
+  for (std::uint16_t c = 0x20; c < 0x7F; ++c) ascii.push_back(c);
+  for (std::uint16_t c = 0x3000; c < 0xA000; ++c) cjk.push_back(c);
+
+  printf("%-20s %-6s %12s %12s %8s %6s %5s\n", "font", "range", "linear ns", "indexed ns", "ratio", "diff", "race");
+  for (auto& f : fonts) {
+    std::uint32_t diff = compare(f.font);
+    bool ok = race(f.font);
+    for (int k = 0; k < 2; ++k) {
+      auto& codes = k ? cjk : ascii;
+      use_linear(f.font, true);
+      double tl = bench(f.font, codes);
+      use_linear(f.font, false);
+      double ti = bench(f.font, codes);
+      printf("%-20s %-6s %12.1f %12.1f %8.2f %6u %5s\n", f.name, k ? "CJK" : "ASCII", tl, ti, tl / ti, diff, ok ? "ok" : "NG");
+    }
+    f.font->releaseGlyphIndex();
+  }
+  return 0;
+}
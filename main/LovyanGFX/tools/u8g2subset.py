@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""u8g2 font subsetter.
+
+Reads a C source containing u8g2 font arrays (bdfconv output such as
+Fonts/IPA/lgfx_font_japan.c) and writes a copy in which the fonts listed in
+the subset file keep only the declared characters. Fonts not listed are
+copied unchanged, so the array names and the rest of the build stay the same.
+
+subset file (one font per line, '#' starts a comment):
+
+  <font array name>  <code | code-code | literal characters> ...
+
+  lgfx_font_japan_mincho_24  0x20 0x2D 0x30-0x39
+  lgfx_font_japan_gothic_16  0x20-0x7E 回転数
+
+usage:
+  python3 u8g2subset.py -c font_subset.txt -o lgfx_font_japan_subset.c lgfx_font_japan.c
+"""
+
+import argparse
+import re
+import sys
+
+ARRAY_RE = re.compile(
+    r'const\s+uint8_t\s+(\w+)\s*\[\s*\d*\s*\][^=;]*=\s*'
+    r'((?:"(?:[^"\\]|\\.)*"\s*)+|\{[^}]*\})\s*;', re.S)
+
+C_ESCAPES = {'n': 10, 't': 9, 'r': 13, 'a': 7, 'b': 8, 'f': 12, 'v': 11,
+             '\\': 92, '"': 34, "'": 39, '?': 63}
+
+
+def parse_c_string(text):
+    out = bytearray()
+    for lit in re.findall(r'"((?:[^"\\]|\\.)*)"', text, re.S):
+        i = 0
+        while i < len(lit):
+            ch = lit[i]
+            if ch != '\\':
+                out += ch.encode('latin-1')
+                i += 1
+                continue
+            i += 1
+            ch = lit[i]
+            if ch in '01234567':
+                j = i
+                while j < len(lit) and j < i + 3 and lit[j] in '01234567':
+                    j += 1
+                out.append(int(lit[i:j], 8) & 0xFF)
+                i = j
+            elif ch == 'x':
+                j = i + 1
+                while j < len(lit) and lit[j] in '0123456789abcdefABCDEF':
+                    j += 1
+                out.append(int(lit[i + 1:j], 16) & 0xFF)
+                i = j
+            else:
+                out.append(C_ESCAPES[ch])
+                i += 1
+    return bytes(out)
+
+
+def parse_array(body):
+    if body.lstrip().startswith('{'):
+        return bytes(int(v, 0) & 0xFF for v in re.findall(r'0[xX][0-9a-fA-F]+|\d+', body))
+    return parse_c_string(body)
+
+
+def word(data, pos):
+    return data[pos] << 8 | data[pos + 1]
+
+
+def split_glyphs(font):
+    """returns (header, [(encoding, glyph bytes)])"""
+    header = font[:23]
+    glyphs = []
+    pos = 23
+    while font[pos + 1]:
+        glyphs.append((font[pos], font[pos:pos + font[pos + 1]]))
+        pos += font[pos + 1]
+    table = 23 + word(font, 21)
+    pos = table + word(font, table)
+    while True:
+        enc = word(font, pos)
+        if enc == 0:
+            break
+        glyphs.append((enc, font[pos:pos + font[pos + 2]]))
+        pos += font[pos + 2]
+    return header, glyphs
+
+
+def build_font(header, glyphs, block=100):
+    ascii_glyphs = [g for e, g in glyphs if e <= 0xFF]
+    uni = [(e, g) for e, g in glyphs if e > 0xFF]
+
+    body = bytearray()
+    pos_A = pos_a = None
+    for e, g in glyphs:
+        if e > 0xFF:
+            break
+        if pos_A is None and e >= ord('A'):
+            pos_A = len(body)
+        if pos_a is None and e >= ord('a'):
+            pos_a = len(body)
+        body += g
+    end_ascii = len(body)
+    body += b'\0\0'
+    if pos_A is None:
+        pos_A = end_ascii
+    if pos_a is None:
+        pos_a = end_ascii
+
+    pos_unicode = len(body)
+    blocks = [uni[i:i + block] for i in range(0, len(uni), block)] or [[]]
+    table = bytearray()
+    glyph_data = bytearray()
+    prev = 0
+    for n, blk in enumerate(blocks):
+        start = len(blocks) * 4 + len(glyph_data)
+        last = 0xFFFF if n == len(blocks) - 1 else blk[-1][0]
+        delta = start - prev
+        prev = start
+        table += bytes((delta >> 8, delta & 0xFF, last >> 8, last & 0xFF))
+        for _, g in blk:
+            glyph_data += g
+    body += table + glyph_data + b'\0\0'
+
+    head = bytearray(header)
+    head[0] = min(len(ascii_glyphs) + len(uni), 255)
+    for idx, v in ((17, pos_A), (19, pos_a), (21, pos_unicode)):
+        head[idx] = v >> 8
+        head[idx + 1] = v & 0xFF
+    return bytes(head + body)
+
+
+def parse_subset(path):
+    subsets = {}
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            name, *specs = line.split()
+            codes = subsets.setdefault(name, set())
+            for spec in specs:
+                m = re.fullmatch(r'(0[xX][0-9a-fA-F]+|\d+)(?:-(0[xX][0-9a-fA-F]+|\d+))?', spec)
+                if m:
+                    a = int(m.group(1), 0)
+                    codes.update(range(a, int(m.group(2) or m.group(1), 0) + 1))
+                else:
+                    codes.update(ord(ch) for ch in spec)
+    return subsets
+
+
+def format_array(name, data):
+    lines = ['const uint8_t %s[%d] = {' % (name, len(data))]
+    for i in range(0, len(data), 16):
+        lines.append('  ' + ','.join('%d' % v for v in data[i:i + 16]) + ',')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='u8g2 font subsetter')
+    ap.add_argument('source')
+    ap.add_argument('-c', '--config', required=True, help='subset file')
+    ap.add_argument('-o', '--output', required=True)
+    args = ap.parse_args()
+
+    subsets = parse_subset(args.config)
+    with open(args.source, encoding='latin-1') as f:
+        text = f.read()
+
+    found = set()
+
+    def replace(m):
+        name = m.group(1)
+        if name not in subsets:
+            return m.group(0)
+        found.add(name)
+        header, glyphs = split_glyphs(parse_array(m.group(2)))
+        keep = [(e, g) for e, g in glyphs if e in subsets[name]]
+        data = build_font(header, keep)
+        sys.stderr.write('%s: %d -> %d glyphs, %d bytes\n' % (name, len(glyphs), len(keep), len(data)))
+        return format_array(name, data)
+
+    text = ARRAY_RE.sub(replace, text)
+    for name in sorted(set(subsets) - found):
+        sys.stderr.write('warning: %s not found in %s\n' % (name, args.source))
+
+    with open(args.output, 'w', encoding='latin-1') as f:
+        f.write(text)
+
+
+if __name__ == '__main__':
+    main()